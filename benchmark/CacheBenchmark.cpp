@@ -0,0 +1,66 @@
+#include "core/Tile.hpp"
+#include "internal/Cache.hpp"
+#include "internal/CacheManager.hpp"
+#include "internal/ClockCache.hpp"
+#include "internal/SpatialCache.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+using rectangle_t = Rectangle<std::size_t>;
+using tile_t = Tile<std::uint8_t>;
+
+constexpr std::size_t grid{64}, tile_size{32}, tile_capacity{1024}, operations{200000};
+constexpr std::size_t capacity{tile_capacity * tile_size * tile_size * sizeof(std::uint8_t)};
+
+/**
+ * Measures the throughput of a cache shared by the given number of threads, each of which performs operations
+ * lookups of random tiles and puts the tile if it is missing, which is what the compute threads do.
+ * As in the graph, where a region is only computed by one task at a time, each tile is only put by one thread.
+ * On fewer cores than threads, the numbers compare the cost of the operations rather than how they scale.
+ */
+template<typename Cache> double throughput(const std::vector<std::shared_ptr<tile_t>>& tiles, std::size_t threads) {
+  Cache cache(capacity);
+  std::vector<std::thread> workers{};
+  const auto start{std::chrono::steady_clock::now()};
+  for (std::size_t t{0}; t < threads; ++t)
+    workers.emplace_back([&cache, &tiles, threads, t] {
+      std::minstd_rand random(std::minstd_rand::result_type(t + 1));
+      // Most requests hit a hot subset of the tiles, which fits into the cache.
+      std::uniform_int_distribution<std::size_t> hot(0, tile_capacity / 2 - 1), all(0, tiles.size() - 1);
+      for (std::size_t i{0}; i < operations; ++i) {
+        const std::size_t index{i % 8 ? hot(random) : all(random)};
+        const auto& tile{tiles[index]};
+        if (not cache.getSynchronized(tile->rectangle()) and index % threads == t)
+          cache.putSynchronized(tile->rectangle(), tile);
+      }
+    });
+  for (auto& worker : workers) worker.join();
+  const std::chrono::duration<double> seconds{std::chrono::steady_clock::now() - start};
+  return double(threads * operations) / seconds.count();
+}
+
+int main() {
+  std::vector<std::shared_ptr<tile_t>> tiles{};
+  for (std::size_t y{0}; y < grid; ++y)
+    for (std::size_t x{0}; x < grid; ++x)
+      tiles.push_back(
+          std::make_shared<tile_t>(rectangle_t{{x * tile_size, y * tile_size}, {tile_size, tile_size}}, 1));
+
+  std::cout << std::setw(8) << "threads" << std::setw(16) << "OrderedMap" << std::setw(16) << "Spatial"
+            << std::setw(16) << "Clock" << std::setw(16) << "Managed" << "  [operations per second]" << std::endl;
+  for (std::size_t threads{1}; threads <= 64; threads *= 2) {
+    std::cout << std::setw(8) << threads;
+    std::cout << std::setw(16) << std::size_t(throughput<OrderedMapCache<rectangle_t, tile_t>>(tiles, threads));
+    std::cout << std::setw(16) << std::size_t(throughput<SpatialCache<rectangle_t, tile_t>>(tiles, threads));
+    std::cout << std::setw(16) << std::size_t(throughput<ClockCache<rectangle_t, tile_t>>(tiles, threads));
+    std::cout << std::setw(16) << std::size_t(throughput<ManagedCache<rectangle_t, tile_t>>(tiles, threads))
+              << std::endl;
+  }
+}
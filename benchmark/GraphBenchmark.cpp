@@ -0,0 +1,139 @@
+#include "core/IndexedGraph.hpp"
+#include "core/MemoryDistribution.hpp"
+#include "core/NodeGraph.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/PerTwoPixels.hpp"
+#include "core/nodes/impl/SimpleSink.hpp"
+#include "core/optimizers/LUTOptimizer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using dimensions_t = Node::dimensions_t;
+using rectangle_t = Node::rectangle_t;
+
+constexpr std::size_t image_size{256}, layer_width{100}, repetitions{5};
+// The greedy planner evaluates every node in every step, which takes minutes beyond this number of nodes.
+constexpr std::size_t greedy_node_limit{2000};
+// The numbers of layers of the measured graphs, the last of which has 5000 nodes.
+constexpr std::array<std::size_t, 4> layer_counts{5, 10, 20, 50};
+
+/**
+ * A source without any computation, as only the structure of the graph is planned.
+ */
+struct SourceNode final : public TiledInputOutputNode<std::uint8_t> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final { return stream << "[SourceNode @ " << this << "]"; }
+
+public:
+  void compute(std::tuple<>, Tile<std::uint8_t>& output) const final { std::fill(output.begin(), output.end(), 0); }
+
+  explicit SourceNode(Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(std::uint8_t)) {}
+};
+
+struct DiscardingSinkNode final : public SimpleSinkNode<std::uint8_t> {
+protected:
+  void handleTile(std::shared_ptr<Tile<std::uint8_t>>) const final {}
+
+public:
+  using SimpleSinkNode::SimpleSinkNode;
+  relevance_t relevance() const final { return 1; }
+};
+
+/**
+ * @return The shortest of the durations of calling the function, in milliseconds.
+ */
+template<typename Function> double milliseconds(Function function, std::size_t count = repetitions) {
+  std::chrono::duration<double, std::milli> best{std::chrono::duration<double, std::milli>::max()};
+  for (std::size_t i{0}; i < count; ++i) {
+    const auto start{std::chrono::steady_clock::now()};
+    function();
+    best = std::min<std::chrono::duration<double, std::milli>>(best, std::chrono::steady_clock::now() - start);
+  }
+  return best.count();
+}
+
+/**
+ * Builds a layered graph of layer_count * layer_width nodes, every fifth layer of which adds two neighbouring nodes of
+ * the previous layer, so that the transitive inputs overlap, while the other layers apply a gamma correction, which
+ * results in many short LUT chains. Every node of the last layer is requested by a sink.
+ */
+void build(NodeGraph& graph, std::size_t layer_count) {
+  std::vector<OutputNode<std::uint8_t>*> layer{};
+  for (std::size_t i{0}; i < layer_width; ++i)
+    layer.push_back(&graph.createOutNode<SourceNode>(dimensions_t{image_size, image_size}));
+  for (std::size_t l{1}; l < layer_count; ++l) {
+    std::vector<OutputNode<std::uint8_t>*> next{};
+    for (std::size_t i{0}; i < layer_width; ++i) {
+      if (l % 5 == 0)
+        next.push_back(&graph.createOutNode<AdditionNode<std::uint8_t, std::uint8_t, std::uint8_t>>(
+            *layer[i], *layer[(i + 1) % layer_width], false));
+      else
+        next.push_back(&graph.createOutNode<GammaNode<std::uint8_t, std::uint8_t>>(*layer[i], false, 1.1f));
+    }
+    layer = std::move(next);
+  }
+  for (auto* node : layer) graph.createSinkNode<DiscardingSinkNode>(*node);
+}
+
+/**
+ * Measures the planning passes on graphs of up to 5000 nodes, with a quarter of the bytes of all nodes as the memory
+ * limit, so that the planners have to choose which nodes to cache. Planning simulates the graph and is only measured
+ * once, and the LUT optimizer changes the graph and is therefore measured on a new graph each time.
+ */
+int main() {
+  std::cout << std::setw(8) << "nodes" << std::setw(12) << "indexed" << std::setw(12) << "members" << std::setw(12)
+            << "greedy" << std::setw(12) << "annealing" << std::setw(12) << "LUT" << "  [ms]" << std::endl;
+  std::cout << std::fixed << std::setprecision(2);
+  for (std::size_t layer_count : layer_counts) {
+    NodeGraph graph{};
+    build(graph, layer_count);
+    const std::size_t memory_limit{image_size * image_size * graph.outNodes().size() / 4};
+    std::cout << std::setw(8) << graph.outNodes().size() << std::flush;
+
+    std::cout << std::setw(12) << milliseconds([&] {
+      const IndexedGraph indexed{graph};
+      indexed.transitiveInputs();
+    }) << std::flush;
+    std::cout << std::setw(12)
+              << milliseconds([&] { MemoryDistribution{memory_limit, graph.outNodes(), graph.sinkNodes()}; })
+              << std::flush;
+    if (graph.outNodes().size() <= greedy_node_limit)
+      std::cout << std::setw(12) << milliseconds([&] {
+        graph.optimizeMemoryDistribution(memory_limit, NodeGraph::Planner::GREEDY, 1, 0);
+      }, 1) << std::flush;
+    else
+      std::cout << std::setw(12) << "-" << std::flush;
+    std::cout << std::setw(12) << milliseconds([&] {
+      graph.optimizeMemoryDistribution(memory_limit, NodeGraph::Planner::ANNEALING, 1, 0);
+    }, 1) << std::flush;
+
+    std::chrono::duration<double, std::milli> best{std::chrono::duration<double, std::milli>::max()};
+    for (std::size_t i{0}; i < repetitions; ++i) {
+      NodeGraph fresh{};
+      build(fresh, layer_count);
+      const auto start{std::chrono::steady_clock::now()};
+      optimizers::LUTOptimizer<internal::default_numbers_t>{}(fresh);
+      best = std::min<std::chrono::duration<double, std::milli>>(best, std::chrono::steady_clock::now() - start);
+    }
+    std::cout << std::setw(12) << best.count() << std::endl;
+  }
+}
@@ -0,0 +1,208 @@
+#include "core/NodeGraph.hpp"
+#include "core/nodes/impl/ChannelCombinator.hpp"
+#include "core/nodes/impl/DirectedConvolution.hpp"
+#include "core/nodes/impl/GaussianBlur.hpp"
+#include "core/nodes/impl/LUTCombinator.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/PerTwoPixels.hpp"
+#include "core/nodes/impl/Resize.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using dimensions_t = Node::dimensions_t;
+using rectangle_t = Node::rectangle_t;
+
+constexpr std::size_t image_size{1024}, tile_offset{64}, min_repetitions{3};
+constexpr std::array<std::size_t, 3> tile_sizes{32, 128, 512};
+constexpr std::array<std::size_t, 2> channel_counts{1, 3};
+constexpr std::chrono::duration<double> min_duration{0.2};
+
+/**
+ * Fills the tile with uniformly distributed values, as done when measuring the durations of tiles.
+ */
+template<typename T> void fill(Tile<T>& tile) {
+  using namespace internal;
+  std::generate(tile.begin(), tile.end(), NumberGenerator<T, pcg_fast_generator<least_floating_point_t<T>>>());
+}
+
+/**
+ * A source of noise, so that the nodes can be measured without image files.
+ */
+template<typename OutputType> struct NoiseNode final : public TiledInputOutputNode<OutputType> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final {
+    return stream << "[NoiseNode<" << internal::type_name<OutputType>() << "> @ " << this << "]";
+  }
+
+public:
+  void compute(std::tuple<>, Tile<OutputType>& output) const final { fill(output); }
+
+  NoiseNode(dimensions_t dimensions, Node::channels_t channels)
+      : OutNode(dimensions, channels, 0, internal::MemoryMode::FULL_MEMORY, typeid(OutputType)) {}
+};
+
+template<typename OutputType, typename... InputTypes, std::size_t... Indices>
+double throughput(const MovingTimeInputOutputNode<OutputType, InputTypes...>& node, rectangle_t region,
+                  std::index_sequence<Indices...>) {
+  std::tuple<Tile<InputTypes>...> inputs{
+      Tile<InputTypes>{node.inputRegion(Indices, region), node.inputNode(Indices).channels()}...};
+  (fill(std::get<Indices>(inputs)), ...);
+  const std::tuple<const Tile<InputTypes>&...> references{std::get<Indices>(inputs)...};
+  Tile<OutputType> output{region, node.channels()};
+
+  node.compute(references, output);
+  std::size_t repetitions{0};
+  const auto start{std::chrono::steady_clock::now()};
+  std::chrono::duration<double> seconds{};
+  do {
+    node.compute(references, output);
+    seconds = std::chrono::steady_clock::now() - start;
+  } while (++repetitions < min_repetitions or seconds < min_duration);
+  return double(repetitions * region.size()) / seconds.count() / 1e6;
+}
+
+/**
+ * Measures the megapixels per second computed by the node for a tile with its inputs already computed, where the tile
+ * is clipped to the node, as the pixels outside of it would not be computed.
+ */
+template<typename OutputType, typename... InputTypes>
+double throughput(const MovingTimeInputOutputNode<OutputType, InputTypes...>& node, rectangle_t& region) {
+  region.clip(node.dimensions());
+  return throughput(node, region, std::index_sequence_for<InputTypes...>{});
+}
+
+struct Result {
+  std::string node, type;
+  // The measured region is the tile clipped to the node.
+  std::size_t channels, tile, width, height;
+  double megapixels_per_second;
+};
+
+/**
+ * A box filter with the given radius, which is as expensive to apply as any other mask of its size.
+ */
+template<typename T> SizedArray<T> boxMask(std::size_t radius) {
+  SizedArray<T> mask(2 * radius + 1);
+  std::fill(mask.begin(), mask.end(), T(1) / T(mask.size()));
+  return mask;
+}
+
+/**
+ * Measures every node type with inputs and outputs of the given type for every channel count and tile size.
+ */
+template<typename T> void benchmark(std::vector<Result>& results) {
+  using least_float_t = internal::least_floating_point_t<T>;
+  const std::string type{internal::type_name<T>()};
+
+  for (std::size_t channels : channel_counts) {
+    NodeGraph graph{};
+    auto& source{graph.createOutNode<NoiseNode<T>>(dimensions_t{image_size, image_size}, channels)};
+    auto& other{graph.createOutNode<NoiseNode<T>>(dimensions_t{image_size, image_size}, channels)};
+
+    const auto measure{[&](std::string name, const auto& node) {
+      for (std::size_t tile : tile_sizes) {
+        rectangle_t region{{tile_offset, tile_offset}, {tile, tile}};
+        const double megapixels_per_second{throughput(node, region)};
+        const Result& result{results.emplace_back(name, type, channels, tile, region.width(), region.height(),
+                                                  megapixels_per_second)};
+        std::cerr << std::setw(32) << result.node << std::setw(16) << result.type << std::setw(4) << channels
+                  << std::setw(6) << tile << std::setw(5) << region.width() << "x" << std::left << std::setw(4)
+                  << region.height() << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+                  << result.megapixels_per_second << " MP/s" << std::endl;
+      }
+    }};
+
+    measure("DirectedConvolutionNode/X", graph.createOutNode<DirectedConvolutionNode<T, T>>(
+                                             source, boxMask<least_float_t>(4), ConvolutionDirection::X, 4, false));
+    measure("DirectedConvolutionNode/Y", graph.createOutNode<DirectedConvolutionNode<T, T>>(
+                                             source, boxMask<least_float_t>(4), ConvolutionDirection::Y, 4, false));
+    measure("GaussianBlurNode", graph.createOutNode<GaussianBlurNode<T, T>>(source, 4.f, .01f, false));
+
+    measure("NearestNeighbourResizeNode",
+            graph.createOutNode<NearestNeighbourResizeNode<T, T>>(source, .75f, .75f, false));
+    measure("BilinearResizeNode", graph.createOutNode<BilinearResizeNode<T, T>>(source, .75f, .75f, false));
+    measure("BicubicResizeNode/convolution",
+            graph.createOutNode<BicubicResizeNode<T, T>>(source, .75f, .75f, false, BicubicMode::CONVOLUTION));
+    measure("BicubicResizeNode/spline",
+            graph.createOutNode<BicubicResizeNode<T, T>>(source, .75f, .75f, false, BicubicMode::SPLINE));
+    measure("LanczosResizeNode",
+            graph.createOutNode<LanczosResizeNode<T, T>>(source, .75f, .75f, false, std::size_t{3}));
+    measure("BlockResizeNode", graph.createOutNode<BlockResizeNode<T, T>>(source, .25f, .25f, false));
+
+    measure("ConvertNode", graph.createOutNode<ConvertNode<T, float32_t>>(source, false));
+    measure("LinearNode", graph.createOutNode<LinearNode<T, T>>(source, false, 1.5f, -.25f));
+    measure("GammaNode", graph.createOutNode<GammaNode<T, T>>(source, false, 2.2f));
+    measure("ClampNode", graph.createOutNode<ClampNode<T, T>>(source, false,
+                                                                internal::convert_normalized<false, T>(.25f),
+                                                                internal::convert_normalized<false, T>(.75f)));
+
+    measure("AdditionNode", graph.createOutNode<AdditionNode<T, T, T>>(source, other, false));
+    measure("SubtractionNode", graph.createOutNode<SubtractionNode<T, T, T>>(source, other, false));
+    measure("MultiplicationNode", graph.createOutNode<MultiplicationNode<T, T, T>>(source, other, false));
+    measure("DivisionNode", graph.createOutNode<DivisionNode<T, T, T>>(source, other, false));
+
+    // The channels of the first input are written to the odd output channels in reverse order, those of the other
+    // input to the even output channels.
+    std::array<SizedArray<std::optional<std::size_t>>, 2> arrays{SizedArray<std::optional<std::size_t>>(channels),
+                                                                 SizedArray<std::optional<std::size_t>>(channels)};
+    for (std::size_t c{0}; c < channels; ++c) arrays[0][c] = 2 * (channels - c) - 1, arrays[1][c] = 2 * c;
+    measure("ChannelCombinatorNode", graph.createOutNode<ChannelCombinatorNode<T, T, T>>(
+                                         std::make_tuple(&source, &other), std::move(arrays), false));
+
+    if constexpr (internal::is_luttable_v<T>) {
+      auto& gamma{graph.createOutNode<GammaNode<T, T>>(source, false, 2.2f)};
+      auto& linear{graph.createOutNode<LinearNode<T, T>>(gamma, false, 1.5f, -.25f)};
+      measure("LUTCombinatorNode", graph.createOutNode<LUTCombinatorNode<T, T>>(
+                                       gamma, std::unordered_set<OutNode*>{&gamma, &linear}, linear));
+    }
+  }
+}
+
+void writeJson(std::ostream& stream, const std::vector<Result>& results) {
+  stream << "{\"benchmark\": \"NodeBenchmark\", \"unit\": \"megapixels_per_second\", \"results\": [";
+  for (std::size_t i{0}; i < results.size(); ++i) {
+    const Result& result{results[i]};
+    stream << (i ? ",\n" : "\n") << "  {\"node\": \"" << result.node << "\", \"type\": \"" << result.type
+           << "\", \"channels\": " << result.channels << ", \"tile\": " << result.tile
+           << ", \"width\": " << result.width << ", \"height\": " << result.height
+           << ", \"megapixels_per_second\": " << result.megapixels_per_second << "}";
+  }
+  stream << "\n]}" << std::endl;
+}
+
+/**
+ * Writes the results as JSON to the file given as the argument or to the standard output, and the progress to the
+ * standard error.
+ */
+int main(int argc, char** argv) {
+  std::vector<Result> results{};
+  benchmark<std::uint8_t>(results);
+  benchmark<std::uint16_t>(results);
+  benchmark<float32_t>(results);
+
+  if (argc > 1) {
+    std::ofstream file{argv[1]};
+    writeJson(file, results);
+    if (not file) {
+      std::cerr << "The results could not be written to " << argv[1] << "!" << std::endl;
+      return 1;
+    }
+  } else
+    writeJson(std::cout, results);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../internal/TileCostModel.hpp"
+#include "ExecutionPlan.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
+namespace ImageGraph {
+/**
+ * The cost models of the kinds of nodes, i.e. of their types and parameters, which are shared by all nodes of the same
+ * kind and can be stored in a profile file, so that each kind is only calibrated once per machine.
+ */
+class CostProfile {
+public:
+  using kind_t = GraphSignature::signature_t;
+  using model_t = internal::TileCostModel;
+
+private:
+  mutable std::mutex mutex_{};
+  absl::flat_hash_map<kind_t, model_t> models_{};
+
+public:
+  /**
+   * The profile used by all nodes, which is never destroyed, as nodes may be destroyed after static destruction.
+   */
+  static CostProfile& global() {
+    static CostProfile* profile{new CostProfile};
+    return *profile;
+  }
+
+  std::optional<model_t> find(kind_t kind) const {
+    std::lock_guard lock{mutex_};
+    auto it{models_.find(kind)};
+    return it == models_.end() ? std::nullopt : std::optional<model_t>{it->second};
+  }
+  void store(kind_t kind, const model_t& model) {
+    std::lock_guard lock{mutex_};
+    models_.insert_or_assign(kind, model);
+  }
+
+  /**
+   * @return Whether the profile could be written.
+   */
+  bool save(const std::filesystem::path& path) const;
+  /**
+   * Adds the models stored in the file, replacing those of the same kinds.
+   * @return Whether the file could be read.
+   */
+  bool load(const std::filesystem::path& path);
+};
+} // namespace ImageGraph
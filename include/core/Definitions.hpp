@@ -1,7 +1,8 @@
 #pragma once
 
+#include "Float16.hpp"
+
 namespace ImageGraph {
-// using float16_t = half_float::half;
 using float32_t = float;
 using float64_t = double;
 } // namespace ImageGraph
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../internal/TileCostModel.hpp"
+#include "nodes/OutNode.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph {
+struct NodeGraph;
+
+/**
+ * Structural hashes of the nodes of a graph, which are the same in every process for the same graph: The hash of a node
+ * combines its type, its description without addresses, its dimensions, channels and memory mode, and the hashes of its
+ * inputs. The nodes are reached from the sinks through their original inputs, so the hashes do not depend on the
+ * optimizers, and a node replacing others is identified by the node whose output it represents.
+ */
+class GraphSignature {
+public:
+  using signature_t = std::uint64_t;
+
+private:
+  absl::flat_hash_map<const Node*, signature_t> nodes_{};
+  // The computed nodes, which include the nodes replacing others.
+  absl::flat_hash_map<const OutNode*, signature_t> outputs_{};
+  // The indices of the computed nodes among those with the same hash.
+  absl::flat_hash_map<const OutNode*, std::size_t> indices_{};
+  signature_t signature_;
+
+  signature_t visit(const Node& node);
+  void number(const OutNode& node, absl::flat_hash_map<signature_t, std::size_t>& counts);
+
+public:
+  explicit GraphSignature(const NodeGraph& graph);
+
+  /**
+   * @return The description of the node with every address and every path="..." replaced by a question mark, which
+   *         is the same for nodes performing the same computation on different files and in every process.
+   */
+  static std::string structuralName(const Node& node);
+  /**
+   * @return The hash of the type and the parameters of the node, i.e. its structural name, and its channels, which is
+   *         shared by all nodes performing the same computation.
+   */
+  static signature_t kind(const Node& node);
+
+  signature_t signature() const { return signature_; }
+  const absl::flat_hash_map<const OutNode*, signature_t>& outputs() const { return outputs_; }
+  /**
+   * @return The index of the computed node among those with the same hash, which is the order in which a depth-first
+   *         traversal from the sinks sorted by their hashes finishes them and thus the same in every process.
+   */
+  std::size_t index(const OutNode& node) const { return indices_.at(&node); }
+};
+
+/**
+ * The result of planning a graph, i.e. the cache bytes of its nodes and the cost models of their tiles, which is
+ * stored on disk so that the planning can be skipped when the same graph is computed again.
+ * Nodes are identified by their structural hashes.
+ */
+struct ExecutionPlan {
+  using signature_t = GraphSignature::signature_t;
+  // A node is identified by its hash and its index among the nodes with the same hash.
+  using node_key_t = std::pair<signature_t, std::size_t>;
+
+  signature_t signature{0};
+  std::size_t memory_limit{0};
+  std::vector<std::pair<node_key_t, std::size_t>> cache_bytes{};
+  std::vector<std::pair<signature_t, internal::TileCostModel>> cost_models{};
+
+  /**
+   * @return The name of the file storing the plan of the graph with the given signature and memory limit.
+   */
+  static std::filesystem::path fileName(signature_t signature, std::size_t memory_limit);
+
+  /**
+   * @return Whether the plan could be written.
+   */
+  bool save(const std::filesystem::path& path) const;
+  /**
+   * @return The stored plan, which is not given if the file is missing or invalid.
+   */
+  static std::optional<ExecutionPlan> load(const std::filesystem::path& path);
+};
+} // namespace ImageGraph
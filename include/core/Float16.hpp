@@ -0,0 +1,109 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace ImageGraph {
+/**
+ * An IEEE 754 half precision number, which is only meant for storage: It converts implicitly from and to float,
+ * in which all arithmetic is performed. Rounding is to the nearest even value.
+ * If the compiler targets F16C, the conversions use it, otherwise they are performed in software.
+ */
+class float16_t {
+  std::uint16_t bits_;
+
+  static constexpr std::uint16_t fromFloat(float value) {
+    const std::uint32_t word{std::bit_cast<std::uint32_t>(value)}, sign{(word >> 16) & 0x8000u},
+        magnitude{word & 0x7fffffffu};
+    // Infinity and NaN, which stays quiet.
+    if (magnitude >= 0x7f800000u) return std::uint16_t(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+    // Everything from 65520 on rounds to infinity.
+    if (magnitude >= 0x477ff000u) return std::uint16_t(sign | 0x7c00u);
+    // Subnormal numbers, i.e. multiples of 2^-24, of which everything up to 2^-25 rounds to zero.
+    if (magnitude < 0x38800000u) {
+      if (magnitude <= 0x33000000u) return std::uint16_t(sign);
+      const std::uint32_t mantissa{(magnitude & 0x7fffffu) | 0x800000u}, shift{126u - (magnitude >> 23)},
+          remainder{mantissa & ((1u << shift) - 1u)}, halfway{1u << (shift - 1u)};
+      std::uint32_t half{mantissa >> shift};
+      if (remainder > halfway or (remainder == halfway and (half & 1u))) ++half;
+      return std::uint16_t(sign | half);
+    }
+    // Normal numbers, whose rounding may carry into the exponent.
+    const std::uint32_t remainder{magnitude & 0x1fffu};
+    std::uint32_t half{(magnitude >> 13) - (112u << 10)};
+    if (remainder > 0x1000u or (remainder == 0x1000u and (half & 1u))) ++half;
+    return std::uint16_t(sign | half);
+  }
+
+  static constexpr float toFloat(std::uint16_t bits) {
+    const std::uint32_t sign{std::uint32_t(bits & 0x8000u) << 16}, exponent{(bits >> 10) & 0x1fu},
+        mantissa{bits & 0x3ffu};
+    if (exponent == 0x1fu) return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+    if (exponent == 0) {
+      const float value{float(mantissa) * 0x1p-24f};
+      return sign ? -value : value;
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+  }
+
+  struct BitsTag {};
+  constexpr float16_t(std::uint16_t bits, BitsTag) : bits_{bits} {}
+
+public:
+  float16_t() = default;
+  constexpr float16_t(float value) : bits_{0} {
+#if defined(__F16C__)
+    if (not std::is_constant_evaluated()) {
+      bits_ = std::uint16_t(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+      return;
+    }
+#endif
+    bits_ = fromFloat(value);
+  }
+
+  constexpr operator float() const {
+#if defined(__F16C__)
+    if (not std::is_constant_evaluated()) return _cvtsh_ss(bits_);
+#endif
+    return toFloat(bits_);
+  }
+
+  constexpr std::uint16_t bits() const { return bits_; }
+  static constexpr float16_t fromBits(std::uint16_t bits) { return {bits, BitsTag{}}; }
+
+  friend inline std::ostream& operator<<(std::ostream& stream, float16_t value) { return stream << float(value); }
+};
+static_assert(sizeof(float16_t) == 2 and std::is_trivially_copyable_v<float16_t>);
+} // namespace ImageGraph
+
+template<> class std::numeric_limits<ImageGraph::float16_t> {
+  using type = ImageGraph::float16_t;
+
+public:
+  static constexpr bool is_specialized{true};
+  static constexpr bool is_signed{true};
+  static constexpr bool is_integer{false};
+  static constexpr bool is_exact{false};
+  static constexpr bool has_infinity{true};
+  static constexpr bool has_quiet_NaN{true};
+  static constexpr bool is_iec559{true};
+  static constexpr int digits{11};
+  static constexpr int digits10{3};
+  static constexpr int max_digits10{5};
+  static constexpr int radix{2};
+  static constexpr int min_exponent{-13};
+  static constexpr int max_exponent{16};
+
+  static constexpr type min() noexcept { return type::fromBits(0x0400u); }
+  static constexpr type max() noexcept { return type::fromBits(0x7bffu); }
+  static constexpr type lowest() noexcept { return type::fromBits(0xfbffu); }
+  static constexpr type epsilon() noexcept { return type::fromBits(0x1400u); }
+  static constexpr type infinity() noexcept { return type::fromBits(0x7c00u); }
+  static constexpr type quiet_NaN() noexcept { return type::fromBits(0x7e00u); }
+};
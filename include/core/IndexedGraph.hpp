@@ -0,0 +1,62 @@
+#pragma once
+
+#include "NodeGraph.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <boost/dynamic_bitset.hpp>
+#include <optional>
+#include <vector>
+
+namespace ImageGraph {
+/**
+ * The structure of a graph with its nodes numbered in topological order, i.e. every node comes after its inputs, and
+ * the inputs and successors stored as indices, so that the planning passes over large graphs are linear and the
+ * transitive inputs of all nodes can be computed as bitsets in a single pass.
+ * The nodes are those reachable from the given sink and out nodes through their original inputs.
+ */
+class IndexedGraph {
+public:
+  using index_t = std::size_t;
+  using indices_t = std::vector<index_t>;
+  using bitset_t = boost::dynamic_bitset<>;
+
+private:
+  std::vector<Node*> nodes_{};
+  // The nodes as out nodes, which is nullptr for the sinks.
+  std::vector<OutNode*> out_nodes_{};
+  absl::flat_hash_map<const Node*, index_t> indices_{};
+  std::vector<indices_t> inputs_{}, successors_{};
+
+  /**
+   * Numbers the node and its inputs which are not numbered yet, without recursion, as the graph may be deep.
+   */
+  void add(Node& root);
+  void connect();
+
+public:
+  IndexedGraph(const NodeGraph::sink_nodes_t& sink_nodes, const NodeGraph::out_nodes_t& out_nodes);
+  explicit IndexedGraph(const NodeGraph::sink_nodes_t& sink_nodes);
+  explicit IndexedGraph(const NodeGraph& graph) : IndexedGraph(graph.sinkNodes(), graph.outNodes()) {}
+
+  std::size_t size() const { return nodes_.size(); }
+  Node& node(index_t index) const { return *nodes_[index]; }
+  OutNode* outNode(index_t index) const { return out_nodes_[index]; }
+  std::optional<index_t> index(const Node& node) const {
+    auto it{indices_.find(&node)};
+    return it == indices_.end() ? std::nullopt : std::optional<index_t>{it->second};
+  }
+
+  /**
+   * @return The indices of the inputs by input index, all of which are smaller than the given index.
+   */
+  const indices_t& inputs(index_t index) const { return inputs_[index]; }
+  /**
+   * @return The indices of the nodes using the node as an input, once per input they use it as.
+   */
+  const indices_t& successors(index_t index) const { return successors_[index]; }
+
+  /**
+   * @return For each node, the set of the indices of its direct and indirect inputs, which needs size()² bits.
+   */
+  std::vector<bitset_t> transitiveInputs() const;
+};
+} // namespace ImageGraph
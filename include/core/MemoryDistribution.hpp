@@ -1,10 +1,12 @@
 #pragma once
 
+#include "../internal/CacheModel.hpp"
 #include "../internal/ProtoGraphAdaptor.hpp"
 #include "../internal/Random.hpp"
 #include "../internal/Typing.hpp"
 #include "NodeGraph.hpp"
 #include <numeric>
+#include <optional>
 
 namespace ImageGraph {
 struct MemoryDistribution {
@@ -18,6 +20,7 @@ struct MemoryDistribution {
   using out_part_t = std::vector<const OutNode*>;
 
   using ProtoGraphAdaptor = internal::ProtoGraphAdaptor;
+  using CacheModel = internal::CacheModel;
 
   struct NodeInformation {
     const OutNode& node;
@@ -31,12 +34,49 @@ struct MemoryDistribution {
   };
 
   using info_t = std::vector<NodeInformation>;
+
+  /**
+   * The behaviour of a cached node predicted by the simulation of a distribution and the one measured while computing
+   * using it, where the durations are those of a computation in seconds.
+   */
+  struct Feedback {
+    const OutNode& node;
+    std::size_t predicted_requests, predicted_computations;
+    OutNode::CacheStatistics measured;
+    cost_t predicted_duration;
+
+    prob_t predictedMissRatio() const {
+      return predicted_requests ? prob_t(predicted_computations) / prob_t(predicted_requests) : 1;
+    }
+    prob_t measuredMissRatio() const {
+      return measured.requests ? prob_t(measured.computations) / prob_t(measured.requests) : 1;
+    }
+    std::optional<cost_t> measuredDuration() const {
+      if (not measured.computations) return std::nullopt;
+      return std::chrono::duration<cost_t>(measured.computation_time).count() / cost_t(measured.computations);
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const Feedback& feedback) {
+      stream << feedback.node << ": miss ratio " << feedback.predictedMissRatio() << " predicted, "
+             << feedback.measuredMissRatio() << " measured with " << feedback.measured.hits << " hits of "
+             << feedback.measured.requests << " requests, duration " << feedback.predicted_duration << "s predicted";
+      if (auto duration{feedback.measuredDuration()}) stream << ", " << *duration << "s measured";
+      return stream;
+    }
+  };
   using argument_tuple_t = std::tuple<const std::size_t, const sinks_t&, info_t, out_part_t, const MemoryAmount>;
 
 private:
   using pcg_t = internal::pcg_fast_generator<prob_t>;
 
+  // Without a model, the distribution is evaluated by simulating the graph using the adaptor.
   mutable ProtoGraphAdaptor adaptor_;
+  const std::shared_ptr<const CacheModel> model_;
+  mutable std::vector<CacheModel::Usage> usages_{};
+  // The number of threads computing the graph, with more than one of which the simulated latencies are the cost.
+  const std::size_t worker_num_;
+  // If not 0, the cost is the simulated time until this number of tiles of each sink is complete.
+  const std::size_t first_tiles_;
   const std::size_t memory_limit_;
   const sinks_t& sink_nodes_;
   info_t cache_nodes_;
@@ -44,30 +84,53 @@ private:
   const MemoryAmount memory_amount_;
   mutable pcg_t generator_{};
 
-  MemoryDistribution(ProtoGraphAdaptor adaptor, const std::size_t memory_limit, const sinks_t& sink_nodes,
-                     info_t cache_nodes, out_part_t non_cache_nodes, const MemoryAmount memory_amount)
-      : adaptor_{std::move(adaptor)}, memory_limit_{memory_limit}, sink_nodes_{sink_nodes},
-        cache_nodes_{std::move(cache_nodes)}, non_cache_nodes_{std::move(non_cache_nodes)}, memory_amount_{
-                                                                                                memory_amount} {}
-
-  static ProtoGraphAdaptor generateAdaptor(const sinks_t& sink_nodes, info_t cache_nodes, out_part_t non_cache_nodes);
+  static ProtoGraphAdaptor generateAdaptor(const sinks_t& sink_nodes, info_t cache_nodes, out_part_t non_cache_nodes,
+                                           std::size_t worker_num, std::size_t first_tiles);
 
-  MemoryDistribution(const std::size_t memory_limit, const sinks_t& sink_nodes, info_t cache_nodes,
-                     out_part_t non_cache_nodes, const MemoryAmount memory_amount)
-      : adaptor_{generateAdaptor(sink_nodes, cache_nodes, non_cache_nodes)}, memory_limit_{memory_limit},
+  MemoryDistribution(std::shared_ptr<const CacheModel> model, const std::size_t worker_num,
+                     const std::size_t first_tiles, const std::size_t memory_limit, const sinks_t& sink_nodes,
+                     info_t cache_nodes, out_part_t non_cache_nodes, const MemoryAmount memory_amount)
+      : adaptor_{model ? ProtoGraphAdaptor{}
+                       : generateAdaptor(sink_nodes, cache_nodes, non_cache_nodes, worker_num, first_tiles)},
+        model_{std::move(model)}, worker_num_{worker_num}, first_tiles_{first_tiles}, memory_limit_{memory_limit},
         sink_nodes_{sink_nodes}, cache_nodes_{std::move(cache_nodes)}, non_cache_nodes_{std::move(non_cache_nodes)},
         memory_amount_{memory_amount} {}
 
-  MemoryDistribution(argument_tuple_t tuple)
-      : MemoryDistribution(std::get<0>(tuple), std::get<1>(tuple), std::move(std::get<2>(tuple)),
-                           std::move(std::get<3>(tuple)), std::move(std::get<4>(tuple))) {}
+  MemoryDistribution(argument_tuple_t tuple, const std::size_t worker_num, const std::size_t first_tiles)
+      : MemoryDistribution(nullptr, worker_num, first_tiles, std::get<0>(tuple), std::get<1>(tuple),
+                           std::move(std::get<2>(tuple)), std::move(std::get<3>(tuple)),
+                           std::move(std::get<4>(tuple))) {}
+
+  /**
+   * @return A distribution of the given bytes using the given model, whose generator is seeded by this one.
+   */
+  MemoryDistribution derive(info_t cache_nodes, std::shared_ptr<const CacheModel> model) const;
+  /**
+   * @return The weighted requests and computations of the node in the last evaluation.
+   */
+  std::pair<prob_t, prob_t> usage(const OutNode& node) const;
+  /**
+   * @return The portion of the bytes which is expected to be wasted due to changes.
+   */
+  static prob_t wasted(const info_t& cache_nodes);
+  /**
+   * @return The cost of the given bytes estimated using the model, which sets the usages.
+   */
+  static cost_t modelCost(const CacheModel& model, const info_t& cache_nodes, std::vector<CacheModel::Usage>& usages);
 
   static argument_tuple_t generate_members(std::size_t memory_limit, const outs_t& out_nodes,
                                            const sinks_t& sink_nodes);
 
 public:
-  MemoryDistribution(const std::size_t memory_limit, const outs_t& out_nodes, const sinks_t& sink_nodes)
-      : MemoryDistribution(generate_members(memory_limit, out_nodes, sink_nodes)) {}
+  /**
+   * @param worker_num The number of threads computing the graph: With one, the cost of a simulated distribution is the
+   *        CPU time of the sinks, otherwise it is their completion time when list scheduled on as many workers.
+   * @param first_tiles If not 0, the cost is the time until the first tiles of each sink around its central point are
+   *        complete instead, which are requested first, e.g. for interactive previews.
+   */
+  MemoryDistribution(const std::size_t memory_limit, const outs_t& out_nodes, const sinks_t& sink_nodes,
+                     const std::size_t worker_num = 1, const std::size_t first_tiles = 0)
+      : MemoryDistribution(generate_members(memory_limit, out_nodes, sink_nodes), worker_num, first_tiles) {}
   MemoryDistribution(MemoryDistribution&&) = default;
   MemoryDistribution(const MemoryDistribution&) = delete;
 
@@ -75,8 +138,53 @@ public:
   const out_part_t& nonCacheNodes() const { return non_cache_nodes_; }
   MemoryAmount memoryAmount() const { return memory_amount_; }
   std::size_t memoryLimit() const { return memory_limit_; }
+  std::size_t workerNum() const { return worker_num_; }
+  std::size_t firstTiles() const { return first_tiles_; }
   const ProtoGraphAdaptor::out_data_map_t& outData() const { return adaptor_.outData(); }
   const ProtoGraphAdaptor::sink_data_map_t& sinkData() const { return adaptor_.sinkData(); }
+  const std::shared_ptr<const CacheModel>& model() const { return model_; }
+
+  /**
+   * @return The model built from the simulation of this distribution, which has to be evaluated without a model.
+   */
+  std::shared_ptr<const CacheModel> buildModel() const;
+  /**
+   * @return The model built from the simulation of this distribution, whose miss ratios are scaled so that they match
+   *         the measured ones at the current bytes and whose durations are the measured ones.
+   */
+  std::shared_ptr<const CacheModel> buildModel(const std::vector<Feedback>& feedback) const;
+  /**
+   * Compares the statistics measured while computing using this distribution with its simulation, which is performed
+   * if necessary and requires the distribution to be evaluated without a model.
+   * @return The feedback of every cached node.
+   */
+  std::vector<Feedback> feedback() const;
+  /**
+   * @return A distribution of the same bytes which is evaluated using the model instead of a simulation.
+   */
+  MemoryDistribution modelled(std::shared_ptr<const CacheModel> model) const { return derive(cache_nodes_, model); }
+  /**
+   * @return A distribution of the same bytes which is evaluated by simulating the graph.
+   */
+  MemoryDistribution simulated() const { return derive(cache_nodes_, nullptr); }
+  /**
+   * @return Whether the cache model estimates the cost, which it only does for the CPU time of the sinks, while their
+   *         completion times on several workers and the time until their first tiles are complete have to be simulated.
+   */
+  bool modelsCost() const { return not first_tiles_ and worker_num_ <= 1; }
+  /**
+   * Distributes the bytes not needed by the nodes whose caches are important in chunks, each of which is given to the
+   * node saving the most time per byte according to the model, considering a few sizes per node to step over plateaus
+   * of its miss ratio curve. This is deterministic and only needs a few model evaluations per node and chunk.
+   * @param model The model estimating the cost, or nullptr to simulate every candidate instead, which is much slower.
+   * @return A distribution using the model.
+   */
+  MemoryDistribution greedy(std::shared_ptr<const CacheModel> model) const;
+
+  /**
+   * Seeds the generator of the random neighbours, whose generators are in turn seeded by this one.
+   */
+  void seed(std::uint64_t seed) { generator_ = pcg_t{seed}; }
 
   cost_t cost() const;
 
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "nodes/Node.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph {
+/**
+ * A registry of counters, gauges and histograms describing the computations and the planning, which can be written as
+ * JSON or in the Prometheus text format. Recording is disabled by default, in which case the instrumented code only
+ * checks a flag, and the diagnostics printed while planning are disabled by default as well.
+ * The metrics are never removed, so references to them stay valid.
+ */
+class Metrics {
+public:
+  using value_t = double;
+  using labels_t = std::vector<std::pair<std::string, std::string>>;
+  using bounds_t = std::vector<value_t>;
+
+  enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+  struct Metric {
+    virtual ~Metric() = default;
+  };
+  class Counter final : public Metric {
+    std::atomic<value_t> value_{0};
+
+  public:
+    void add(value_t value = 1) { value_ += value; }
+    value_t value() const { return value_; }
+  };
+  class Gauge final : public Metric {
+    std::atomic<value_t> value_{0};
+
+  public:
+    void set(value_t value) { value_ = value; }
+    void add(value_t value) { value_ += value; }
+    /**
+     * Sets the gauge to the value if it is larger, e.g. to track a peak.
+     */
+    void max(value_t value) {
+      for (value_t old{value_}; old < value and not value_.compare_exchange_weak(old, value);) {}
+    }
+    value_t value() const { return value_; }
+  };
+  class Histogram final : public Metric {
+    const bounds_t bounds_;
+    // The number of observations in each bucket, the last of which has no upper bound.
+    std::unique_ptr<std::atomic<std::size_t>[]> counts_;
+    std::atomic<value_t> sum_{0};
+
+  public:
+    /**
+     * @param bounds The sorted upper bounds of the buckets.
+     */
+    explicit Histogram(bounds_t bounds)
+        : bounds_{std::move(bounds)}, counts_{std::make_unique<std::atomic<std::size_t>[]>(bounds_.size() + 1)} {}
+
+    void observe(value_t value);
+
+    const bounds_t& bounds() const { return bounds_; }
+    /**
+     * @return The number of observations in the bucket with the given index, which does not include the lower ones.
+     */
+    std::size_t bucket(std::size_t index) const { return counts_[index]; }
+    value_t sum() const { return sum_; }
+  };
+
+private:
+  struct Family {
+    Type type;
+    std::string help;
+    bounds_t bounds;
+    std::map<labels_t, std::unique_ptr<Metric>> metrics{};
+  };
+
+  mutable std::mutex mutex_{};
+  std::map<std::string, Family> families_{};
+  inline static std::atomic<bool> enabled_{false}, verbose_{false};
+
+  Metric& get(const std::string& name, Type type, const std::string& help, const labels_t& labels,
+              const bounds_t& bounds);
+
+public:
+  /**
+   * The registry used by the library, which is never destroyed, as it may be used during static destruction.
+   */
+  static Metrics& global() {
+    static Metrics* metrics{new Metrics};
+    return *metrics;
+  }
+
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void setEnabled(bool enabled) { enabled_ = enabled; }
+  /**
+   * @return Whether diagnostics such as the planning results are printed.
+   */
+  static bool verbose() { return verbose_.load(std::memory_order_relaxed); }
+  static void setVerbose(bool verbose) { verbose_ = verbose; }
+
+  /**
+   * @return The bounds first, first * factor, ..., i.e. count bounds growing exponentially.
+   */
+  static bounds_t exponentialBounds(value_t first, value_t factor, std::size_t count);
+  /**
+   * @return The label identifying the node, which is its structural name, i.e. its description without addresses
+   *         and paths, so that it is the same in every run.
+   */
+  static std::string nodeLabel(const Node& node);
+  /**
+   * @return The structural name followed by the given index, which tells apart nodes with the same structural name.
+   */
+  static std::string nodeLabel(const Node& node, std::size_t index);
+
+  /**
+   * The metric with the given name and labels is created if it does not exist yet. All metrics with the same name
+   * have to have the same type.
+   */
+  Counter& counter(const std::string& name, const std::string& help, const labels_t& labels = {}) {
+    return static_cast<Counter&>(get(name, Type::COUNTER, help, labels, {}));
+  }
+  Gauge& gauge(const std::string& name, const std::string& help, const labels_t& labels = {}) {
+    return static_cast<Gauge&>(get(name, Type::GAUGE, help, labels, {}));
+  }
+  /**
+   * @param bounds The upper bounds of the buckets, which are those of the first histogram with the given name.
+   */
+  Histogram& histogram(const std::string& name, const std::string& help, const labels_t& labels = {},
+                       const bounds_t& bounds = exponentialBounds(1e-6, 4, 12)) {
+    return static_cast<Histogram&>(get(name, Type::HISTOGRAM, help, labels, bounds));
+  }
+
+  void writeJson(std::ostream& stream) const;
+  void writePrometheus(std::ostream& stream) const;
+};
+} // namespace ImageGraph
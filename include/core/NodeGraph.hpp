@@ -3,9 +3,11 @@
 #include "../internal/BorrowedPtr.hpp"
 #include "../internal/GraphAdaptor.hpp"
 #include "../internal/ProtoCache.hpp"
+#include "ExecutionPlan.hpp"
 #include "Optimizer.hpp"
 #include "nodes/OptimizedOutNode.hpp"
 #include "nodes/SinkNode.hpp"
+#include <thread>
 #include <unordered_set>
 
 namespace ImageGraph {
@@ -21,6 +23,12 @@ struct NodeGraph {
   using optimizers_t = std::vector<std::unique_ptr<Optimizer>>;
   using duration_t = std::chrono::duration<double>;
 
+  /**
+   * How the cache bytes are distributed: Annealing explores more distributions, while the greedy planner is faster and
+   * deterministic.
+   */
+  enum class Planner { ANNEALING, GREEDY };
+
 private:
   struct PoolID {
     internal::Task& task;
@@ -35,6 +43,14 @@ private:
 
   bool handleFinished(internal::GraphAdaptor& adaptor, pool_deque_t finished, pool_t& pool);
   bool performSingle(task_dependency_deque_t finished, pool_t& pool);
+  /**
+   * Computes the sinks using the current cache sizes of the nodes, counting the cache statistics of the nodes anew.
+   * @param first_tiles The number of tiles of every sink which are requested before any sink requests more.
+   */
+  void computeTasks(std::optional<size_t> opt_thread_num, std::size_t first_tiles = 0);
+  static std::size_t threadNum(std::optional<size_t> opt_thread_num) {
+    return opt_thread_num ? *opt_thread_num : std::thread::hardware_concurrency();
+  }
 
   enum class RunState { NOT_RUNNING, STOP_RUNNING, RUNNING };
 
@@ -89,10 +105,62 @@ public:
 
   void finish();
 
-  duration_t computationDuration(std::size_t size);
-  MemoryDistribution optimizeMemoryDistribution(std::size_t memory_limit) const;
-  void compute(MemoryDistribution distribution, std::optional<size_t> opt_thread_num = std::nullopt);
-  void compute(std::size_t memory_limit, std::optional<size_t> opt_thread_num = std::nullopt);
+  /**
+   * @param cache_bytes The maximum number of bytes of the cache of each node.
+   * @param worker_num The number of threads the computation is simulated on.
+   * @return The simulated makespan, which is the sum of the durations of all tasks for a single thread.
+   */
+  duration_t computationDuration(std::size_t cache_bytes, std::size_t worker_num = 1);
+  /**
+   * Latencies are optimized by simulating every candidate, which is much slower than optimizing the CPU time.
+   * @param opt_thread_num The number of threads used for annealing, which does not change the result.
+   * @param opt_seed The seed making the result of annealing deterministic, which is random if not given.
+   * @param worker_num The number of threads computing the graph, with more than one of which the simulated latency of
+   *        the sinks is optimized instead of their CPU time.
+   * @param first_tiles If not 0, the time until this number of tiles around the central point of each sink is complete
+   *        is optimized instead.
+   */
+  MemoryDistribution optimizeMemoryDistribution(std::size_t memory_limit, Planner planner = Planner::ANNEALING,
+                                                std::optional<size_t> opt_thread_num = std::nullopt,
+                                                std::optional<std::uint64_t> opt_seed = std::nullopt,
+                                                std::size_t worker_num = 1, std::size_t first_tiles = 0) const;
+  /**
+   * The first tiles of the sinks the distribution is optimized for are requested before all other tiles.
+   */
+  void compute(const MemoryDistribution& distribution, std::optional<size_t> opt_thread_num = std::nullopt);
+  /**
+   * Plans again using the cache statistics measured while computing using the given distribution, which has been
+   * evaluated without a model, e.g. for the next run or the next item of a batch, and prints the prediction error of
+   * every cached node.
+   * @return The distribution planned using the model corrected by the measurements, which is evaluated by simulation.
+   */
+  MemoryDistribution replanMemoryDistribution(const MemoryDistribution& distribution,
+                                              Planner planner = Planner::ANNEALING,
+                                              std::optional<size_t> opt_thread_num = std::nullopt,
+                                              std::optional<std::uint64_t> opt_seed = std::nullopt) const;
+  /**
+   * Only the CPU time is optimized, while optimizeMemoryDistribution can optimize the latency on several threads.
+   * @param first_tiles If not 0, the time until this number of tiles of each sink is complete is minimized, e.g. for
+   *        interactive previews, and these tiles are requested before all other tiles.
+   */
+  void compute(std::size_t memory_limit, std::optional<size_t> opt_thread_num = std::nullopt,
+               Planner planner = Planner::ANNEALING, std::size_t first_tiles = 0);
+
+  /**
+   * @return The plan of the graph using the given distribution and the cost models fitted so far.
+   */
+  ExecutionPlan plan(std::size_t memory_limit, const MemoryDistribution& distribution) const;
+  /**
+   * Computes the graph using the cache bytes and cost models of the plan, which has to belong to this graph.
+   */
+  void compute(const ExecutionPlan& plan, std::optional<size_t> opt_thread_num = std::nullopt);
+  /**
+   * Computes the graph using the plan stored in the directory if there is one for this graph and memory limit.
+   * Otherwise, the graph is planned and the plan is stored after computing, when the cost models are refined.
+   * The cost models of the kinds of nodes are shared by all plans in the directory using a profile file.
+   */
+  void compute(std::size_t memory_limit, const std::filesystem::path& plan_directory,
+               std::optional<size_t> opt_thread_num = std::nullopt, Planner planner = Planner::ANNEALING);
 
   friend std::ostream& operator<<(std::ostream& stream, const NodeGraph& graph) {
     stream << "********************************************************************************\n";
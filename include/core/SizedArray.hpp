@@ -1,11 +1,15 @@
 #pragma once
 
 #include "../internal/Debugging.hpp"
+#include "../internal/TilePool.hpp"
 #include "../internal/UniquePtrIterator.hpp"
 
 namespace ImageGraph {
 template<typename T> class SizedArray {
-  std::unique_ptr<T[]> data_;
+  using deleter_t = internal::ArrayDeleter<T>;
+  using pointer_t = std::unique_ptr<T[], deleter_t>;
+
+  pointer_t data_;
   const std::size_t size_;
 
   static inline std::unique_ptr<T[]> fromInitializerList(const std::initializer_list<T>& list) {
@@ -16,8 +20,8 @@ template<typename T> class SizedArray {
   }
 
 public:
-  using iterator = internal::UniquePtrIterator<T, false>;
-  using const_iterator = internal::UniquePtrIterator<T, true>;
+  using iterator = internal::UniquePtrIterator<T, false, deleter_t>;
+  using const_iterator = internal::UniquePtrIterator<T, true, deleter_t>;
 
   const_iterator begin() const { return {data_, 0}; }
   iterator begin() { return {data_, 0}; }
@@ -44,5 +48,17 @@ public:
   SizedArray(std::unique_ptr<T[]>&& data, std::size_t size) : data_{std::move(data)}, size_{size} {}
   explicit SizedArray(std::size_t size) : data_{std::make_unique<T[]>(size)}, size_{size} {}
   SizedArray(SizedArray&&) noexcept = default;
+
+  /**
+   * Creates an array whose elements are not initialized, which is taken from the TilePool and returned to it.
+   */
+  static SizedArray uninitialized(std::size_t size) requires(std::is_trivially_default_constructible_v<T> and
+                                                             std::is_trivially_destructible_v<T>) {
+    T* data{static_cast<T*>(internal::TilePool::allocate(size * sizeof(T)))};
+    return SizedArray(pointer_t{data, deleter_t{size}}, size);
+  }
+
+private:
+  SizedArray(pointer_t&& data, std::size_t size) : data_{std::move(data)}, size_{size} {}
 };
 } // namespace ImageGraph
@@ -4,6 +4,7 @@
 #include "SizedArray.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -69,17 +70,30 @@ public:
   const T& at(std::size_t x, std::size_t y, std::size_t c) const { return at(channels_ * (x + width() * y) + c); }
   T& at(std::size_t x, std::size_t y, std::size_t c) { return at(channels_ * (x + width() * y) + c); }
 
+  /**
+   * @return The number of samples between two neighbouring rows.
+   */
+  std::size_t stride() const { return channels_ * width(); }
+  /**
+   * @return A pointer to the first sample of the pixel at the given absolute position, which has to be in the tile.
+   */
+  const T* pixel(std::size_t x, std::size_t y) const {
+    return data() + stride() * (y - top()) + channels_ * (x - left());
+  }
+  T* pixel(std::size_t x, std::size_t y) { return data() + stride() * (y - top()) + channels_ * (x - left()); }
+
+  /**
+   * Copies the overlap of both tiles from other, one row at a time.
+   */
   void copyOverlap(const Tile& other) {
     DEBUG_ASSERT_S(std::invalid_argument, channels_ == other.channels_, "Cannot copy a tile with ", other.channels_,
                    " channels to a tile with ", channels_, " channels!");
-    const std::size_t channels{channels_}, x_begin{std::max(left(), other.left())},
-        y_begin{std::max(top(), other.top())}, x_end{std::min(left() + width(), other.left() + other.width())},
+    const std::size_t x_begin{std::max(left(), other.left())}, y_begin{std::max(top(), other.top())},
+        x_end{std::min(left() + width(), other.left() + other.width())},
         y_end{std::min(top() + height(), other.top() + other.height())};
-    for (std::size_t y{y_begin}; y < y_end; ++y)
-      for (std::size_t x{x_begin}; x < x_end; ++x)
-        for (std::size_t channel{0}; channel < channels; ++channel)
-          data_[channels * ((y - top()) * width() + x - left()) + channel] =
-              other.data_[channels * ((y - other.top()) * other.width() + x - other.left()) + channel];
+    if (x_begin >= x_end) return;
+    const std::size_t row_bytes{sizeof(T) * channels_ * (x_end - x_begin)};
+    for (std::size_t y{y_begin}; y < y_end; ++y) std::memcpy(pixel(x_begin, y), other.pixel(x_begin, y), row_bytes);
   }
   void writeToFile(const std::string& path) const {
     VipsImage* image{vips_image_new_from_memory(data(), size() * sizeof(T), width(), height(), channels(),
@@ -100,8 +114,11 @@ public:
     return stream;
   }
 
+  /**
+   * Creates a tile whose data is not initialized and is recycled by the TilePool.
+   */
   Tile(Rectangle<pixel_index_t> rectangle, channels_t channels)
-      : rectangle_{rectangle}, channels_{channels}, data_(rectangle.size() * channels) {}
+      : rectangle_{rectangle}, channels_{channels}, data_{array_t::uninitialized(rectangle.size() * channels)} {}
   Tile(Rectangle<pixel_index_t> rectangle, channels_t channels, SizedArray<T>&& data)
       : rectangle_{rectangle}, channels_{channels}, data_{std::move(data)} {
     DEBUG_ASSERT_S(std::invalid_argument, data_.size() == rectangle.size() * channels, "data.size() = ", data_.size(),
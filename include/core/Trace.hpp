@@ -0,0 +1,88 @@
+#pragma once
+
+#include "nodes/Node.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+
+namespace ImageGraph {
+/**
+ * Records what each thread does over time, i.e. the tasks performed by the workers and the tiles generated or found in
+ * the cache by the coordinator, which can be written in the Chrome trace format to be viewed in Perfetto.
+ * Each thread records into its own ring buffer without locking, which keeps the latest events if it overflows.
+ * Tracing is disabled by default, in which case recording only checks a flag.
+ * CAUTION The nodes are only described when writing, so they have to exist and the computation has to be finished.
+ */
+class Trace {
+public:
+  using time_point_t = std::chrono::steady_clock::time_point;
+  using rectangle_t = Node::rectangle_t;
+
+  struct Event {
+    // The name of the event, which has to be a string literal.
+    const char* name;
+    const Node* node;
+    rectangle_t region{Node::dimensions_t{}};
+    // The type of the task, which is nullptr for coordinator events.
+    const std::type_info* type;
+    // The start and the duration in nanoseconds since the start of the trace, where instant events have no duration.
+    std::int64_t start, duration;
+    // The finished dependency which the event handled, which is nullptr if there is none.
+    const Node* dependency;
+    rectangle_t dependency_region{Node::dimensions_t{}};
+  };
+
+private:
+  inline static std::atomic<bool> enabled_{false};
+
+  static std::int64_t sinceStart(time_point_t time);
+  static void record(const Event& event);
+
+public:
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void setEnabled(bool enabled) { enabled_ = enabled; }
+  /**
+   * Sets the number of events kept per thread, which applies to the buffers of threads that have not recorded yet.
+   */
+  static void setCapacity(std::size_t capacity);
+  /**
+   * Names the current thread in the trace, e.g. to tell the coordinator from the workers.
+   */
+  static void nameThread(std::string name);
+
+  static time_point_t now() { return std::chrono::steady_clock::now(); }
+  /**
+   * Records an event of the current thread which started at the given time and ends now.
+   */
+  static void complete(const char* name, const Node& node, rectangle_t region, const std::type_info& type,
+                       time_point_t start) {
+    const std::int64_t start_ns{sinceStart(start)};
+    record({name, &node, region, &type, start_ns, sinceStart(now()) - start_ns, nullptr, {Node::dimensions_t{}}});
+  }
+  /**
+   * Records an event of the current thread which started at the given time, ends now and handled the given region of
+   * a finished dependency.
+   */
+  static void complete(const char* name, const Node& node, rectangle_t region, const std::type_info& type,
+                       time_point_t start, const Node& dependency, rectangle_t dependency_region) {
+    const std::int64_t start_ns{sinceStart(start)};
+    record({name, &node, region, &type, start_ns, sinceStart(now()) - start_ns, &dependency, dependency_region});
+  }
+  /**
+   * Records an event of the current thread without a duration.
+   */
+  static void instant(const char* name, const Node& node, rectangle_t region) {
+    record({name, &node, region, nullptr, sinceStart(now()), -1, nullptr, {Node::dimensions_t{}}});
+  }
+
+  /**
+   * Discards the recorded events, which must not be called while events are recorded.
+   */
+  static void clear();
+  static void writeChromeJson(std::ostream& stream);
+};
+} // namespace ImageGraph
@@ -1,6 +1,9 @@
 #pragma once
 
+#include "../../internal/CacheManager.hpp"
+#include "../../internal/GreedyDualCache.hpp"
 #include "OutputNode.hpp"
+
 namespace ImageGraph {
 /**
  * The MemoryMode ANY_MEMORY is expected!
@@ -15,10 +18,29 @@ struct CachedOutputNode : public virtual OutputNode<OutputType> {
   using cache_t = Cache<rectangle_t, tile_t>;
 
 private:
-  mutable cache_t cache_{};
+  /**
+   * Caches which weigh their entries, such as GreedyDualCache, are given the recomputation cost of a tile per byte.
+   */
+  cache_t createCache() const {
+    if constexpr (requires { typename cache_t::weight_function_t; })
+      return cache_t{0, [this](const rectangle_t& rectangle) { return cacheWeight(rectangle); }};
+    else
+      return cache_t{};
+  }
+
+  mutable cache_t cache_{createCache()};
+
+public:
+  /**
+   * @return The time needed to recompute the region in nanoseconds divided by the number of bytes it occupies.
+   */
+  double cacheWeight(const rectangle_t& rectangle) const {
+    const std::size_t bytes{rectangle.size() * this->channels() * sizeof(OutputType)};
+    return bytes ? this->tileDuration(rectangle).count() / double(bytes) : 0.;
+  }
 
 public:
-  void setCacheSize(std::size_t size) const final { cache_.resize(size); }
+  void setCacheBytes(std::size_t bytes) const final { cache_.resize(bytes); }
   shared_tile_t cacheGet(const rectangle_t& rectangle) const final { return cache_.get(rectangle); }
   shared_tile_t cacheGetSynchronized(const rectangle_t& rectangle) const final {
     return cache_.getSynchronized(rectangle);
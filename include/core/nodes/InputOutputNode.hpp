@@ -65,11 +65,15 @@ protected:
     void performFullImpl() final {
       using namespace std::chrono;
 
-      auto output{std::make_shared<Tile<OutputType>>(region_, node_.channels())};
+      // The tile, its data and the control block are all recycled by the TilePool.
+      auto output{std::allocate_shared<Tile<OutputType>>(internal::PoolAllocator<Tile<OutputType>>{}, region_,
+                                                         node_.channels())};
       {
         const auto start_time{steady_clock::now()};
         node_.compute(internal::ct::ref_map<0, sizeof...(InputTypes), FutureRemover>(results_), *output);
-        node_.updateTileDuration(duration_cast<OutNode::duration_t>(steady_clock::now() - start_time), this->region());
+        const auto duration{duration_cast<OutNode::duration_t>(steady_clock::now() - start_time)};
+        node_.updateTileDuration(duration, this->region());
+        node_.countComputationTime(duration);
       }
       node_.cachePutSynchronized(this->region(), output);
       DEBUG_ASSERT(std::runtime_error, output, "The output is nullptr!");
@@ -100,7 +104,7 @@ protected:
     const InputOutputNode& node_;
     Tiler tiler_;
     std::vector<InputInfo> results_{};
-    std::unique_ptr<Tile<OutputType>> output_{};
+    std::shared_ptr<Tile<OutputType>> output_{};
     std::mutex mutex_{};
 
     const Node& node() const final { return node_; }
@@ -117,11 +121,13 @@ protected:
     }
 
     /**
+     * Each finished tile is copied into the output as soon as it is available and released afterwards, so that the
+     * copies are spread over the workers and the tiles do not have to be kept until the region is complete.
      * CAUTION This is only safe if the tiles do not overlap!
      */
     void performSingleImpl(const Node& node, rectangle_t rectangle) final {
       DEBUG_ASSERT(std::invalid_argument, &node == &node_, "The given node is not the stored node!");
-      std::shared_ptr<Tile<OutputType>> tile;
+      shared_tile_t<OutputType> tile;
       {
         std::lock_guard guard{mutex_};
         auto iterator{std::find_if(results_.begin(), results_.end(),
@@ -130,7 +136,10 @@ protected:
         tile = iterator->future.get();
         results_.erase(iterator);
 
-        if (not output_) output_ = std::make_unique<Tile<OutputType>>(tiler_.rectangle(), node_.channels());
+        // The tile, its data and the control block are all recycled by the TilePool.
+        if (not output_)
+          output_ = std::allocate_shared<Tile<OutputType>>(internal::PoolAllocator<Tile<OutputType>>{},
+                                                           tiler_.rectangle(), node_.channels());
       }
       output_->copyOverlap(*tile);
     }
@@ -150,9 +159,8 @@ protected:
      * @param region The region to be tiled. The actual tiling is determined by adaptor.
      */
     TilingTask(const InputOutputNode& node, internal::GraphAdaptor& adaptor, rectangle_t region, dimensions_t tile)
-        : internal::TypedTask<shared_tile_t<OutputType>>(adaptor, region), node_{node}, tiler_{region,
-                                                                                               node.dimensions(),
-                                                                                               tile} {}
+        : internal::TypedTask<shared_tile_t<OutputType>>(adaptor, region), node_{node},
+          tiler_{region, node.dimensions(), tile} {}
   };
 
   class ComputeTileProtoTask final : public internal::ProtoOutTask {
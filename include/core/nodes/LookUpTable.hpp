@@ -39,6 +39,13 @@ protected:
    */
   virtual void computeRaw(const InputType* input, OutputType* output, const std::size_t size,
                           const bool is_lookup) const = 0;
+  /**
+   * Computes a tile, which is passed on to computeRaw by default.
+   * Nodes depending on the position of the tile, e.g. for dithering, can override this.
+   */
+  virtual void computeTile(const Tile<InputType>& input, Tile<OutputType>& output) const {
+    computeRaw(input.data(), output.data(), output.size(), false);
+  }
 
 public:
   SizedArray<OutputType> computeLUT() const final {
@@ -76,7 +83,7 @@ protected:
     // TODO Ensure this before calling!
     DEBUG_ASSERT_S(std::runtime_error, input_size == output_size, "The input tile has size ", input_size,
                    " which differs from the size ", output_size, " of the output tile!");
-    this->computeRaw(input.data(), output.data(), output_size, false);
+    this->computeTile(input, output);
   }
 };
 } // namespace ImageGraph
@@ -1,53 +1,129 @@
 #pragma once
 
 #include "../../internal/Random.hpp"
+#include "../../internal/TileCostModel.hpp"
 #include "../../internal/typing/NumberTraits.hpp"
+#include "../CostProfile.hpp"
 #include "CachedOutputNode.hpp"
 #include "TiledInputOutputNode.hpp"
+#include <mutex>
+#include <optional>
 
 namespace ImageGraph {
+/**
+ * A node whose tile durations are predicted by a TileCostModel, which is calibrated by measuring a few regions unless
+ * the CostProfile contains a model of the same kind of node, and refined using the measured durations of the tiles.
+ */
 struct MovingTimeOutNode : virtual public OutNode {
   using factor_t = double;
+  using model_t = internal::TileCostModel;
 
 private:
-  mutable internal::OrderedMapCache<dimensions_t, duration_t> cache_;
+  // The number of observations a model needs before it is stored in the CostProfile, which the calibration exceeds.
+  static constexpr std::size_t min_stored_observations{16};
+
+  mutable std::mutex mutex_{};
+  mutable model_t model_{};
+  // Whether tiles have been observed since the model was stored.
+  mutable bool refined_{false};
   const factor_t factor_;
+  // The kind of the node, which is computed once, as it requires describing the node.
+  mutable std::once_flag kind_flag_{};
+  mutable CostProfile::kind_t kind_{};
+
+  CostProfile::kind_t kind() const {
+    std::call_once(kind_flag_, [this] { kind_ = GraphSignature::kind(*this); });
+    return kind_;
+  }
+
+  /**
+   * @return The features of the region, whose halo consists of the input pixels beyond the output pixels.
+   */
+  model_t::features_t features(rectangle_t region) const {
+    const std::size_t pixels{region.size()};
+    std::size_t halo_pixels{0};
+    for (std::size_t i{0}; i < inputCount(); ++i) {
+      const std::size_t input_pixels{inputRegion(i, region).size()};
+      if (input_pixels > pixels) halo_pixels += input_pixels - pixels;
+    }
+    return model_t::features(pixels, halo_pixels);
+  }
+  /**
+   * Measures square regions of several sizes in the middle of the node, where the halo is not clipped.
+   */
+  model_t calibrate() const {
+    model_t model{};
+    for (std::size_t size : {16, 32, 64, 128}) {
+      const dimensions_t dimensions{std::min(size, width()), std::min(size, height())};
+      const rectangle_t region{{(width() - dimensions.width()) / 2, (height() - dimensions.height()) / 2}, dimensions};
+      model.observe(features(region), computeDuration(region).count());
+    }
+    return model;
+  }
 
 protected:
-  virtual duration_t computeDuration(dimensions_t dimensions) const = 0;
+  virtual duration_t computeDuration(rectangle_t region) const = 0;
   /**
    * This function is synchronized, i.e. it locks a mutex!
-   * @param duration The new duration to update the value with.
+   * If the node has no model yet, the model of its kind in the global CostProfile is refined instead of a new one.
+   * @param duration The measured duration of the region.
    * @param region The region to which the duration belongs.
    */
   void updateTileDuration(duration_t duration, rectangle_t region) const final {
-    auto dimensions{region.dimensions()};
-    std::lock_guard lock{cache_.mutex()};
-    auto ptr{cache_.get(dimensions)};
-    if (ptr)
-      *ptr = factor_ * duration + (1. - factor_) * *ptr;
-    else
-      cache_.put(dimensions, std::move(duration));
+    const auto region_features{features(region)};
+    std::unique_lock lock{mutex_};
+    if (model_.empty()) {
+      lock.unlock();
+      auto profiled{CostProfile::global().find(kind())};
+      lock.lock();
+      if (profiled and model_.empty()) model_ = std::move(*profiled);
+    }
+    model_.observe(region_features, duration.count(), factor_);
+    refined_ = true;
   }
   /**
-   * This function is not synchronized!
+   * This function is synchronized, as cost-aware caches call it when tiles are put, but the model is calibrated
+   * without holding the lock.
    * @param region The region to compute the computation time of.
    * @return The computation time.
    */
   duration_t tileDuration(rectangle_t region) const final {
-    auto dimensions{region.dimensions()};
-    auto ptr{cache_.get(dimensions)};
-    if (ptr)
-      return *ptr;
-    else {
-      auto duration{computeDuration(dimensions)};
-      cache_.put(dimensions, duration_t(duration));
-      return duration;
+    const auto region_features{features(region)};
+    {
+      std::lock_guard lock{mutex_};
+      if (not model_.empty()) return duration_t{model_.predict(region_features)};
     }
+    auto model{CostProfile::global().find(kind())};
+    if (not model) {
+      model = calibrate();
+      CostProfile::global().store(kind(), *model);
+    }
+    std::lock_guard lock{mutex_};
+    if (model_.empty()) model_ = std::move(*model);
+    return duration_t{model_.predict(region_features)};
   }
 
 public:
-  MovingTimeOutNode(std::size_t cache_size = 8, factor_t factor = 1e-2) : cache_{cache_size}, factor_{factor} {}
+  std::optional<model_t> costModel() const final {
+    std::lock_guard lock{mutex_};
+    return model_.empty() ? std::nullopt : std::optional<model_t>{model_};
+  }
+  void loadCostModel(const model_t& model) const final {
+    std::lock_guard lock{mutex_};
+    model_ = model;
+  }
+  void storeCostModel() const final {
+    model_t model{};
+    {
+      std::lock_guard lock{mutex_};
+      if (not refined_ or model_.observations() < min_stored_observations) return;
+      refined_ = false;
+      model = model_;
+    }
+    CostProfile::global().store(kind(), model);
+  }
+
+  MovingTimeOutNode(factor_t factor = 1e-2) : factor_{factor} {}
 };
 
 template<typename OutputType, typename... InputTypes> struct MovingTimeInputOutputNode
@@ -77,12 +153,9 @@ protected:
   }
   virtual void computeImpl(std::tuple<const Tile<InputTypes>&...> inputs, Tile<OutputType>& output) const = 0;
 
-  virtual rectangle_t durationRectangle(dimensions_t dimensions) const { return {dimensions}; }
-
-  duration_t computeDuration(dimensions_t dimensions) const final {
+  duration_t computeDuration(rectangle_t rectangle) const final {
     using namespace std::chrono;
 
-    rectangle_t rectangle{durationRectangle(dimensions)};
     std::tuple<Tile<InputTypes>...> raw_inputs{durationInputs(rectangle)};
     std::tuple<const Tile<InputTypes>&...> inputs{raw_inputs};
     Tile<OutputType> output{rectangle, this->channels()};
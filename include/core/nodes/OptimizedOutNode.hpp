@@ -9,7 +9,7 @@ class OptimizedOutNode : public virtual OutNode {
 
 public:
   OptimizedOutNode(std::unordered_set<OutNode*> children) : children_{std::move(children)} {
-    for (auto& child : children_) child->addParent(this);
+    for (auto& child : children_) child->addParent(this, this);
   }
   ~OptimizedOutNode() {
     for (auto& child : children_) child->removeLastParent(this);
@@ -3,9 +3,14 @@
 #include "../../internal/ProtoCache.hpp"
 #include "../../internal/ProtoTask.hpp"
 #include "../../internal/Task.hpp"
+#include "../../internal/TileCostModel.hpp"
+#include "../Metrics.hpp"
 #include "Node.hpp"
+#include <atomic>
 #include <iostream>
+#include <optional>
 #include <stack>
+#include <string>
 
 namespace ImageGraph {
 class OptimizedOutNode;
@@ -17,9 +22,14 @@ struct OutNode : public Node {
      * which ensures that this information is always valid, I hope.
      */
     OptimizedOutNode* parent;
+    /**
+     * The parent as an OutNode, which cannot be cast from parent here, where OptimizedOutNode is incomplete.
+     */
+    OutNode* node;
     bool is_output;
 
-    ParentPair(OptimizedOutNode* parent, bool is_output) : parent{parent}, is_output{is_output} {}
+    ParentPair(OptimizedOutNode* parent, OutNode* node, bool is_output)
+        : parent{parent}, node{node}, is_output{is_output} {}
   };
 
   using successor_count_t = std::size_t;
@@ -28,11 +38,35 @@ struct OutNode : public Node {
   using proto_cache_t = internal::ProtoCache<rectangle_t>;
   using probability_t = double;
 
+  /**
+   * The requests of regions of the node while computing, the hits of its cache, the tasks created to compute the
+   * missing regions and the time spent computing its tiles, which can be compared to the simulation.
+   */
+  struct CacheStatistics {
+    std::size_t requests{0}, hits{0}, computations{0};
+    duration_t computation_time{0};
+  };
+
 private:
   const std::type_info& output_type_;
   parents_t parents_{};
   successor_count_t successor_count_;
   probability_t change_probability_{0};
+  mutable std::atomic<std::size_t> requests_{0}, hits_{0}, computations_{0};
+  mutable std::atomic<duration_t::rep> computation_time_{0};
+  // The histogram of the tile computation times in the global metrics, which is registered on first use.
+  mutable std::atomic<Metrics::Histogram*> tile_seconds_{nullptr};
+  mutable std::string metrics_label_{};
+
+  Metrics::Histogram& tileSeconds() const {
+    Metrics::Histogram* histogram{tile_seconds_.load(std::memory_order_acquire)};
+    if (not histogram) {
+      histogram = &Metrics::global().histogram("imagegraph_tile_seconds", "The time spent computing a tile.",
+                                               {{"node", metricsLabel()}});
+      tile_seconds_.store(histogram, std::memory_order_release);
+    }
+    return *histogram;
+  }
 
 protected:
   /**
@@ -62,16 +96,16 @@ public:
   const OutNode& outputNode() const {
     if (parents_.empty()) return *this;
 
-    auto& [top_parent, top_output]{parents_.top()};
-    if (top_output) return (const OutNode&)(*top_parent);
+    const auto& top_parent{parents_.top()};
+    if (top_parent.is_output) return *top_parent.node;
 
     throw std::runtime_error("There is a parent, but it is not representing this node!");
   }
   OutNode& outputNode() {
     if (parents_.empty()) return *this;
 
-    auto& [top_parent, top_output]{parents_.top()};
-    if (top_output) return (OutNode&)(*top_parent);
+    const auto& top_parent{parents_.top()};
+    if (top_parent.is_output) return *top_parent.node;
 
     throw std::runtime_error("There is a parent, but it is not representing this node!");
   }
@@ -80,9 +114,23 @@ public:
 
   virtual std::unique_ptr<internal::ProtoOutTask> protoTask(rectangle_t region) const = 0;
 
+  /**
+   * @return The model of the computation times of tiles if there is one, which can be restored using loadCostModel.
+   */
+  virtual std::optional<internal::TileCostModel> costModel() const { return std::nullopt; }
+  /**
+   * Restores the model of the computation times of tiles, so that they need not be measured again.
+   */
+  virtual void loadCostModel(const internal::TileCostModel&) const {}
+  /**
+   * Stores the model refined by the measured computation times in the global CostProfile, which is done once the
+   * computation is finished instead of for every tile.
+   */
+  virtual void storeCostModel() const {}
+
   const ParentPair& topParent() const { return parents_.top(); }
   bool hasParents() const { return not parents_.empty(); }
-  void addParent(OptimizedOutNode* parent) { parents_.emplace(parent, false); }
+  void addParent(OptimizedOutNode* parent, OutNode* node) { parents_.emplace(parent, node, false); }
   void setParentOutput(const OptimizedOutNode* parent) {
     auto& top_parent{parents_.top()};
     DEBUG_ASSERT(std::invalid_argument, top_parent.parent == parent, "The given node is not the topmost parent!");
@@ -95,19 +143,53 @@ public:
 
   virtual std::size_t elementBytes() const = 0;
   std::size_t fullByteNumber() const { return elementBytes() * dimensions().size() * channels(); }
-  virtual std::size_t cacheSizeFromBytes(std::size_t byte_num) const = 0;
+  /**
+   * @return The number of bytes occupied by a tile of the given region.
+   */
+  std::size_t regionBytes(rectangle_t region) const { return elementBytes() * region.size() * channels(); }
 
   virtual probability_t changeProbability() const { return change_probability_; }
   virtual void setChangeProbability(probability_t probability) { change_probability_ = probability; }
 
-  virtual void setCacheSize(std::size_t size) const = 0;
-  virtual void setCacheBytes(std::size_t bytes) const { setCacheSize(cacheSizeFromBytes(bytes)); }
+  /**
+   * Sets the maximum number of bytes occupied by the tiles in the cache.
+   */
+  virtual void setCacheBytes(std::size_t bytes) const = 0;
   virtual bool isCacheable(rectangle_t) const { return false; }
   /**
    * @return A ProtoCache that has the same contents as the cache.
    */
   virtual std::unique_ptr<proto_cache_t> createProtoCache() const = 0;
 
+  /**
+   * Counts a request of a region of the node, which either hits the cache, creates a task or joins an existing one.
+   */
+  void countRequest(bool hit, bool computed) const {
+    ++requests_;
+    if (hit) ++hits_;
+    if (computed) ++computations_;
+  }
+  void countComputationTime(duration_t duration) const {
+    computation_time_ += duration.count();
+    if (Metrics::enabled()) tileSeconds().observe(std::chrono::duration<double>(duration).count());
+  }
+  CacheStatistics cacheStatistics() const {
+    return {requests_.load(), hits_.load(), computations_.load(), duration_t{computation_time_.load()}};
+  }
+  void resetCacheStatistics() const { requests_ = 0, hits_ = 0, computations_ = 0, computation_time_ = 0; }
+
+  /**
+   * @return The label identifying the node in the metrics, which is its structural name if it has not been set.
+   */
+  std::string metricsLabel() const { return metrics_label_.empty() ? Metrics::nodeLabel(*this) : metrics_label_; }
+  /**
+   * Sets the label identifying the node in the metrics, which must not be called while the node is computed.
+   */
+  void setMetricsLabel(std::string label) const {
+    metrics_label_ = std::move(label);
+    tile_seconds_.store(nullptr, std::memory_order_relaxed);
+  }
+
   successor_count_t successorCount() const { return successor_count_; }
   void addSuccessor() { ++successor_count_; }
   void removeSuccessor() { --successor_count_; }
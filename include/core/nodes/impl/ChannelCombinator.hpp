@@ -5,21 +5,26 @@
 #include <boost/dynamic_bitset.hpp>
 
 namespace ImageGraph::nodes {
-template<typename OutputType, typename... InputTypes> struct ChannelCombinatorNode final
-    : public TiledCachedOutputNode<OutputType>,
-      public MovingTimeInputOutputNode<OutputType, InputTypes...> {
+/**
+ * @tparam Cache The cache type, which comes first as the input types are variadic. ChannelCombinatorNode uses the
+ *         default cache.
+ */
+template<template<typename, typename> typename Cache, typename OutputType, typename... InputTypes>
+struct BasicChannelCombinatorNode final : public TiledCachedOutputNode<OutputType, Cache>,
+                                          public MovingTimeInputOutputNode<OutputType, InputTypes...> {
   using dimensions_t = Node::dimensions_t;
   using rectangle_t = Node::rectangle_t;
   using input_index_t = Node::input_index_t;
 
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
   using channel_array_t = SizedArray<std::optional<std::size_t>>;
   using channel_arrays_t = std::array<channel_array_t, sizeof...(InputTypes)>;
 
 private:
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
   const channel_arrays_t channel_array_;
+  // Whether every output channel is written by an input.
+  const bool channels_complete_;
 
   struct MaximumCallable {
     constexpr static inline dimensions_t call(const dimensions_t d1, const dimensions_t d2) {
@@ -30,11 +35,11 @@ private:
     static inline dimensions_t call(const OutNode* node) { return node->dimensions(); }
   };
 
-  template<bool Dither, std::size_t Index, typename... Args> struct CalcCallable {
-    using element_t = std::tuple_element_t<Index, std::tuple<InputTypes...>>;
-
+  template<typename... Streams> struct CalcCallable {
+    template<std::size_t Index>
     static inline void call(const std::tuple<const Tile<InputTypes>&...>& inputs, Tile<OutputType>& output,
-                            const channel_arrays_t& channel_arrays, Args&... args) {
+                            const channel_arrays_t& channel_arrays, Streams&... streams) {
+      using element_t = std::tuple_element_t<Index, std::tuple<InputTypes...>>;
       const Tile<element_t>& input{std::get<Index>(inputs)};
       const std::size_t channels{input.channels()};
       const channel_array_t& channel_array{channel_arrays[Index]};
@@ -47,19 +52,21 @@ private:
         if (element) used_channels.emplace_back(i, *element);
       }
 
-      const auto width{input.width()}, height{input.height()};
+      // The inputs only fill some of the output channels, so the streams have to be told the position, which is that
+      // in the output, as smaller inputs only cover part of it.
+      const auto width{input.width()}, height{input.height()}, output_width{output.width()},
+          output_channels{output.channels()};
       for (std::size_t y{0}; y < height; ++y)
         for (std::size_t x{0}; x < width; ++x)
-          for (const auto [input_channel, output_channel] : used_channels)
-            output(x, y, output_channel) =
-                internal::convert_normalized<Dither, OutputType>(input(x, y, input_channel), args...);
+          for (const auto [input_channel, output_channel] : used_channels) {
+            internal::dither_seek(output_channels * (x + output_width * y) + output_channel, streams...);
+            output(x, y, output_channel) = internal::convert_normalized<sizeof...(Streams) != 0, OutputType>(
+                input(x, y, input_channel), streams...);
+          }
     }
   };
-  template<std::size_t Index> using DitherCalcCallable = CalcCallable<true, Index, pcg_t>;
-  template<std::size_t Index> using NoDitherCalcCallable = CalcCallable<false, Index>;
-
-  template<std::size_t Index> struct InputTypeOutputCallable {
-    static inline void call(std::ostream& stream) {
+  struct InputTypeOutputCallable {
+    template<std::size_t Index> static inline void call(std::ostream& stream) {
       using namespace internal;
       stream << ", " << type_name<std::tuple_element_t<Index, std::tuple<InputTypes...>>>();
     }
@@ -73,14 +80,24 @@ private:
     return max_channel;
   }
 
+  /**
+   * @return Whether every sample of the output is written by an input.
+   */
+  bool isComplete(const std::tuple<const Tile<InputTypes>&...>& inputs, const Tile<OutputType>& output) const {
+    if (not channels_complete_) return false;
+    return std::apply(
+        [&output](const auto&... input) { return ((input.rectangle() == output.rectangle()) and ...); }, inputs);
+  }
+
 protected:
   void computeImpl(std::tuple<const Tile<InputTypes>&...> inputs, Tile<OutputType>& output) const final {
-    if (generator_)
-      internal::ct::for_all<0, sizeof...(InputTypes), DitherCalcCallable>(
-          std::cref(inputs), std::ref(output), std::cref(channel_array_), std::ref(*generator_));
-    else
-      internal::ct::for_all<0, sizeof...(InputTypes), NoDitherCalcCallable>(std::cref(inputs), std::ref(output),
-                                                                            std::cref(channel_array_));
+    // The output is not initialized, so the samples which are not written by any input are set to zero.
+    if (not isComplete(inputs, output)) std::fill_n(output.data(), output.size(), OutputType{});
+    ditherer_.perform<least_float_t>(output, [&](auto&... streams) {
+      using calculator_t = CalcCallable<std::remove_reference_t<decltype(streams)>...>;
+      internal::ct::for_all<0, sizeof...(InputTypes), calculator_t>(
+          std::cref(inputs), std::ref(output), std::cref(channel_array_), std::ref(streams)...);
+    });
   }
 
   rectangle_t rawInputRegion(input_index_t, rectangle_t rectangle) const final { return rectangle; }
@@ -104,15 +121,21 @@ protected:
       stream << "}";
       if (++it1 != channel_array_.end()) stream << ", ";
     }
-    return stream << "}) @ " << this << "]";
+    return stream << "}, dither=" << ditherer_.mode() << ") @ " << this << "]";
   }
 
 public:
-  ChannelCombinatorNode(std::tuple<OutputNode<InputTypes>*...>&& inputs, channel_arrays_t&& arrays, bool dither)
+  BasicChannelCombinatorNode(std::tuple<OutputNode<InputTypes>*...>&& inputs, channel_arrays_t&& arrays,
+                             internal::Ditherer dither)
       : OutNode(internal::ct::transform_reduce<dimensions_t, MaximumCallable, DimensionsCallable>(inputs, 0),
                 maxChannel(arrays) + 1, sizeof...(InputTypes), internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputTypes...>(std::move(inputs), false),
-        generator_{dither ? std::optional<pcg_t>(pcg_t()) : std::optional<pcg_t>()}, channel_array_{std::move(arrays)} {
+        ditherer_{dither}, channel_array_{std::move(arrays)}, channels_complete_{[this] {
+          std::size_t used{0};
+          for (const auto& vector : channel_array_)
+            for (const auto& ptr : vector) used += bool(ptr);
+          return used == this->channels();
+        }()} {
     DEBUG_ASSERT_P(
         std::invalid_argument,
         [this] {
@@ -125,4 +148,7 @@ public:
         "Multiple inputs write to the same channel!");
   }
 };
+
+template<typename OutputType, typename... InputTypes> using ChannelCombinatorNode =
+    BasicChannelCombinatorNode<internal::SpatialCache, OutputType, InputTypes...>;
 } // namespace ImageGraph::nodes
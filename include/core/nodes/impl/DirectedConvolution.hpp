@@ -3,6 +3,7 @@
 #include "../../../internal/Mathematics.hpp"
 #include "../MovingTime.hpp"
 #include <exception>
+#include <optional>
 
 namespace ImageGraph::nodes {
 enum class ConvolutionDirection { X, Y };
@@ -11,16 +12,20 @@ static inline std::ostream& operator<<(std::ostream& stream, const ConvolutionDi
     case ConvolutionDirection::X: return stream << "X";
     case ConvolutionDirection::Y: return stream << "Y";
   }
+  return stream;
 }
 
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>>
-struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
+/**
+ * @tparam Cache The cache type, e.g. internal::GreedyDualCache to prefer keeping convolved tiles over cheaper ones.
+ */
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType, Cache>,
                                        public MovingTimeInputOutputNode<OutputType, InputType> {
   using dimensions_t = Node::dimensions_t;
   using rectangle_t = Node::rectangle_t;
   using input_index_t = Node::input_index_t;
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
 
   template<ConvolutionDirection Direction> constexpr static inline rectangle_t
   inputRegion(const rectangle_t rectangle, const size_t mask_size, const size_t offset) {
@@ -43,7 +48,7 @@ struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
    * @tparam Direction The direction in which the convolution is supposed to proceed.
    * @tparam Dither Whether or not to dither when converting between types.
    * @tparam Args Additional arguments for dithering.
-   *              This is empty if Dither == false, otherwise a random number generator.
+   *              This is empty if Dither == false, otherwise a DitherStream.
    * @param in_tile The input tile.
    *                Preconditions: in_tile.channels() == out_tile.channels() and out_tile.subsetOf(in_tile)
    * @param out_tile The output tile into which the result will be written.
@@ -71,13 +76,12 @@ struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
      * If the OutputType is floating point, the results are stored directly into the output tile,
      * otherwise a temporary tile of least_float_t is created.
      */
-    std::unique_ptr<Tile<least_float_t>> work_ptr{};
+    std::optional<Tile<least_float_t>> work{};
     Tile<least_float_t>* work_tile_ptr;
     if constexpr (std::is_same_v<OutputType, least_float_t>) {
       work_tile_ptr = &out_tile;
     } else {
-      work_ptr = std::make_unique<Tile<least_float_t>>(out_tile.rectangle(), channels);
-      work_tile_ptr = work_ptr.get();
+      work_tile_ptr = &work.emplace(out_tile.rectangle(), channels);
     }
     Tile<least_float_t>& work_tile{*work_tile_ptr};
 
@@ -86,6 +90,8 @@ struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
         out_width{out_tile.width()};
     // The index offsets in the x and y axes between the output and input.
     const std::size_t x_offset{out_tile.left() - in_tile.left()}, y_offset{out_tile.top() - in_tile.top()};
+    // The sums of the current output pixel, which are reset for every pixel instead of allocating them anew.
+    SizedArray<least_float_t> together(channels);
 
     if constexpr (Direction == ConvolutionDirection::Y) {
       for (std::size_t out_y{0}; out_y < out_height; ++out_y) {
@@ -97,7 +103,7 @@ struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
 
         for (std::size_t out_x{0}; out_x < out_width; ++out_x) {
           const std::size_t in_x{out_x + x_offset};
-          SizedArray<least_float_t> together(channels);
+          std::fill_n(together.data(), channels, _0);
           for (size_t in_y{y_begin}, i{kernel_offset}; in_y < y_end; ++in_y, ++i) {
             const auto kern{kernel.at(i)};
             for (size_t channel{0}; channel < channels; ++channel)
@@ -117,7 +123,7 @@ struct DirectedConvolutionNode final : public TiledCachedOutputNode<OutputType>,
               x_end{std::min<std::size_t>(out_x + x_offset + from_center, in_width)};
 
           least_float_t norm{_0};
-          SizedArray<least_float_t> together(channels);
+          std::fill_n(together.data(), channels, _0);
           for (size_t in_x{x_begin}, i{kernel_offset}; in_x < x_end; ++in_x, ++i) {
             const auto kern{kernel.at(i)};
             norm += kern;
@@ -143,24 +149,19 @@ private:
   ConvolutionDirection direction_;
   const SizedArray<least_float_t> mask_;
   const size_t offset_;
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
 
 protected:
   void computeImpl(std::tuple<const Tile<InputType>&> inputs, Tile<OutputType>& output) const final {
-    switch (direction_) {
-      case ConvolutionDirection::Y: {
-        if (generator_)
-          return compute<ConvolutionDirection::Y, true>(std::get<0>(inputs), output, mask_, offset_, *generator_);
-        else
-          return compute<ConvolutionDirection::Y, false>(std::get<0>(inputs), output, mask_, offset_);
-      }
-      case ConvolutionDirection::X: {
-        if (generator_)
-          return compute<ConvolutionDirection::X, true>(std::get<0>(inputs), output, mask_, offset_, *generator_);
-        else
-          return compute<ConvolutionDirection::X, false>(std::get<0>(inputs), output, mask_, offset_);
+    ditherer_.perform<least_float_t>(output, [&](auto&... stream) {
+      constexpr bool dither{sizeof...(stream) != 0};
+      switch (direction_) {
+        case ConvolutionDirection::Y:
+          return compute<ConvolutionDirection::Y, dither>(std::get<0>(inputs), output, mask_, offset_, stream...);
+        case ConvolutionDirection::X:
+          return compute<ConvolutionDirection::X, dither>(std::get<0>(inputs), output, mask_, offset_, stream...);
       }
-    }
+    });
   }
 
   rectangle_t rawInputRegion(input_index_t, rectangle_t output_rectangle) const final {
@@ -170,6 +171,7 @@ protected:
       case ConvolutionDirection::X:
         return inputRegion<ConvolutionDirection::X>(output_rectangle, mask_.size(), offset_);
     }
+    throw std::invalid_argument("The convolution direction is invalid!");
   }
 
   std::ostream& print(std::ostream& stream) const override {
@@ -182,10 +184,10 @@ protected:
 
 public:
   DirectedConvolutionNode(OutputNode<InputType>& input, SizedArray<least_float_t>&& mask,
-                          ConvolutionDirection direction, size_t offset, bool dither)
+                          ConvolutionDirection direction, size_t offset, internal::Ditherer dither)
       : OutNode(input.dimensions(), input.channels(), 1, internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputType>(input, false), direction_{direction}, mask_{std::move(mask)}, offset_{offset},
-        generator_{dither ? std::optional<pcg_t>(pcg_t()) : std::optional<pcg_t>()} {
+        ditherer_{dither} {
     DEBUG_ASSERT(std::invalid_argument, offset_ < mask_.size(), "The offset is not smaller than the mask size!");
   }
 };
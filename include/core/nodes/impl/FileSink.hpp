@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../../internal/GraphAdaptor.hpp"
+#include "../../../internal/Json.hpp"
 #include "../../../internal/Typing.hpp"
 #include "../../../internal/tilers/HilbertSpiral.hpp"
 #include "../../../internal/typing/Vips.hpp"
@@ -43,7 +44,7 @@ template<typename InputType> class FileSinkNode final : public SinkNode {
         std::lock_guard guard{mutex_};
         results_.emplace_back(rect, std::move(result.future_tile));
       }
-      if (result.finished) return std::make_optional<RequiredTaskInfo>(node_.input_, rect);
+      if (result.finished) return std::make_optional<RequiredTaskInfo>(node_.input_.outputNode(), rect);
       return std::nullopt;
     }
 
@@ -51,7 +52,8 @@ template<typename InputType> class FileSinkNode final : public SinkNode {
      * CAUTION This is only safe if the tiles do not overlap!
      */
     void performSingleImpl(const Node& node, rectangle_t rectangle) final {
-      DEBUG_ASSERT(std::invalid_argument, &node == &node_.input_, "The given node is not the stored node!");
+      DEBUG_ASSERT(std::invalid_argument, &node == &node_.input_.outputNode(),
+                   "The given node is not the stored node!");
       std::shared_ptr<Tile<InputType>> tile;
       {
         std::lock_guard guard{mutex_};
@@ -133,8 +135,9 @@ public:
   point_t centralPoint() const final { return {this->width() / 2, this->height() / 2}; }
 
   std::ostream& print(std::ostream& stream) const final {
-    return stream << "[FileSinkNode<" << internal::type_name<InputType>() << ">(input=" << &input_ << ", path=\""
-                  << out_path_ << "\") @ " << this << "]";
+    stream << "[FileSinkNode<" << internal::type_name<InputType>() << ">(input=" << &input_ << ", path=\"";
+    internal::writeEscaped(stream, out_path_);
+    return stream << "\") @ " << this << "]";
   }
 };
 } // namespace ImageGraph::nodes
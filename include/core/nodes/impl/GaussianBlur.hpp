@@ -4,8 +4,12 @@
 #include "DirectedConvolution.hpp"
 
 namespace ImageGraph::nodes {
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>>
-struct GaussianBlurNode final : public TiledCachedOutputNode<OutputType>,
+/**
+ * @tparam Cache The cache type, e.g. internal::GreedyDualCache to prefer keeping blurred tiles over cheaper ones.
+ */
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+struct GaussianBlurNode final : public TiledCachedOutputNode<OutputType, Cache>,
                                 public MovingTimeInputOutputNode<OutputType, InputType> {
   using dimensions_t = Node::dimensions_t;
   using rectangle_t = Node::rectangle_t;
@@ -13,7 +17,6 @@ struct GaussianBlurNode final : public TiledCachedOutputNode<OutputType>,
   using duration_t = OutNode::duration_t;
 
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
 
 private:
   constexpr static least_float_t SQRT_TWO{internal::math::sqrt<least_float_t>(2)};
@@ -21,7 +24,7 @@ private:
   const least_float_t sigma_, minimum_amplitude_;
   const size_t mask_size_;
   const SizedArray<least_float_t> mask_;
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
 
   constexpr static inline size_t maskSize(least_float_t sigma, least_float_t minimum_amplitude) {
     return std::ceil(SQRT_TWO * sigma * std::sqrt(-std::log(minimum_amplitude)));
@@ -60,13 +63,11 @@ protected:
     const Tile<InputType>& input_tile_x(std::get<0>(inputs));
     Tile<least_float_t> input_tile_y(input_rectangle_y, this->channels());
 
-    if (generator_) {
-      x_convolution_t::template compute<X, true>(input_tile_x, input_tile_y, mask_, mask_size_, *generator_);
-      y_convolution_t::template compute<Y, true>(input_tile_y, output, mask_, mask_size_, *generator_);
-    } else {
-      x_convolution_t::template compute<X, false>(input_tile_x, input_tile_y, mask_, mask_size_);
-      y_convolution_t::template compute<Y, false>(input_tile_y, output, mask_, mask_size_);
-    }
+    ditherer_.perform<least_float_t>(output, [&](auto&... stream) {
+      constexpr bool dither{sizeof...(stream) != 0};
+      x_convolution_t::template compute<X, dither>(input_tile_x, input_tile_y, mask_, mask_size_, stream...);
+      y_convolution_t::template compute<Y, dither>(input_tile_y, output, mask_, mask_size_, stream...);
+    });
   }
 
   rectangle_t rawInputRegion(input_index_t, rectangle_t output_rectangle) const final {
@@ -90,10 +91,11 @@ protected:
 public:
   bool isCacheImportant() const final { return true; }
 
-  GaussianBlurNode(OutputNode<InputType>& input, least_float_t sigma, least_float_t minimum_amplitude, bool dither)
+  GaussianBlurNode(OutputNode<InputType>& input, least_float_t sigma, least_float_t minimum_amplitude,
+                   internal::Ditherer dither)
       : OutNode(input.dimensions(), input.channels(), 1, internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputType>(input, false), sigma_{sigma}, minimum_amplitude_{minimum_amplitude},
         mask_size_{maskSize(sigma, minimum_amplitude)}, mask_{calcMask(sigma, mask_size_)},
-        generator_{dither ? std::optional<pcg_t>(pcg_t()) : std::optional<pcg_t>()} {}
+        ditherer_{dither} {}
 };
 } // namespace ImageGraph::nodes
@@ -6,9 +6,12 @@
 
 namespace ImageGraph {
 namespace nodes {
-template<typename OutputType, typename InputType>
+/**
+ * @tparam Cache The cache type, which the LUTOptimizer leaves at its default.
+ */
+template<typename OutputType, typename InputType, template<typename, typename> typename Cache = internal::SpatialCache>
 requires internal::is_luttable_v<InputType> struct LUTCombinatorNode final
-    : public TiledCachedOutputNode<OutputType>,
+    : public TiledCachedOutputNode<OutputType, Cache>,
       public OptimizedOutputNode<OutputType>,
       public MovingTimeInputOutputNode<OutputType, InputType> {
   using dimensions_t = Node::dimensions_t;
@@ -1,31 +1,54 @@
 #pragma once
 
+#include "../../../internal/typing/BulkConversion.hpp"
 #include "../LookUpTable.hpp"
 
 namespace ImageGraph::nodes {
-template<typename InputType, typename OutputType, template<typename In, typename Out> typename Callable>
-struct PerPixelOutNode final : public TiledCachedOutputNode<OutputType>,
+/**
+ * @tparam Cache The cache type, which is also selectable through the aliases of the callables.
+ */
+template<typename InputType, typename OutputType, template<typename In, typename Out> typename Callable,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+struct PerPixelOutNode final : public TiledCachedOutputNode<OutputType, Cache>,
                                public MovingTimeLUTInputOutputNode<InputType, OutputType> {
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
   using call_t = Callable<InputType, OutputType>;
   using args_t = typename call_t::args_t;
 
 private:
   const args_t attributes_;
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
+
+  /**
+   * Whether the callable can compute whole arrays at once, which it signals by providing computeBulk.
+   */
+  template<typename... Streams> static constexpr bool is_bulk{
+      requires(const InputType* input, OutputType* output, const args_t& args, Streams&... streams) {
+        call_t::computeBulk(input, output, std::size_t{}, args, streams...);
+      }};
 
 protected:
-  void computeRaw(const InputType* input, OutputType* output, const std::size_t size,
-                  const bool is_lookup) const final {
-    using namespace internal;
-    if (this->generator_ and not is_lookup)
-      for (size_t i{0}; i < size; ++i)
-        output[i] = call_t::template compute<true>(input[i], attributes_, *this->generator_);
+  /**
+   * Look-up tables are never dithered, as their entries are shared by all pixels.
+   */
+  void computeRaw(const InputType* input, OutputType* output, const std::size_t size, const bool) const final {
+    if constexpr (is_bulk<>)
+      call_t::computeBulk(input, output, size, attributes_);
     else
       for (size_t i{0}; i < size; ++i) output[i] = call_t::template compute<false>(input[i], attributes_);
   }
 
+  void computeTile(const Tile<InputType>& input, Tile<OutputType>& output) const final {
+    const std::size_t size{output.size()};
+    ditherer_.perform<least_float_t>(output, [&](auto&... stream) {
+      if constexpr (is_bulk<std::remove_reference_t<decltype(stream)>...>)
+        call_t::computeBulk(input.data(), output.data(), size, attributes_, stream...);
+      else
+        for (size_t i{0}; i < size; ++i)
+          output[i] = call_t::template compute<sizeof...(stream) != 0>(input[i], attributes_, stream...);
+    });
+  }
+
   std::ostream& print(std::ostream& stream) const final {
     using namespace internal;
     stream << "[";
@@ -33,19 +56,21 @@ protected:
     stream << "<" << type_name<InputType>() << ", " << type_name<OutputType>()
            << ">(input=" << &this->typedInputNode() << ", ";
     if (call_t::argumentNames(stream, attributes_)) stream << ", ";
-    stream << "dither=" << generator_.has_value();
+    stream << "dither=" << ditherer_.mode();
     return stream << ") @ " << this << "]";
   }
 
 public:
-  template<typename... Args> PerPixelOutNode(OutputNode<InputType>& input, bool dither, Args&&... args)
+  template<typename... Args>
+  PerPixelOutNode(OutputNode<InputType>& input, internal::Ditherer dither, Args&&... args)
       : OutNode(input.dimensions(), input.channels(), 1, internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputType>(input, false), attributes_{std::forward<Args>(args)...},
-        generator_{dither ? std::optional<pcg_t>(pcg_t()) : std::optional<pcg_t>()} {}
+        ditherer_{dither} {}
 };
 
 namespace {
 template<typename InputType, typename OutputType> struct ConvertCallable {
+  using least_float_t = internal::least_floating_point_t<OutputType>;
   using args_t = std::tuple<>;
 
   static inline std::ostream& nodeName(std::ostream& stream) { return stream << "ConvertNode"; }
@@ -55,10 +80,31 @@ template<typename InputType, typename OutputType> struct ConvertCallable {
   static inline constexpr OutputType compute(InputType input, const args_t&, Args&... rands) {
     return internal::convert_normalized<Dither, OutputType>(input, rands...);
   }
+
+  /**
+   * Uses the bulk conversions, which are only dithered for integral outputs.
+   */
+  template<typename... Streams>
+  requires internal::is_bulk_convertible_v<OutputType, InputType> and
+      (sizeof...(Streams) == 0 or internal::is_integral_v<OutputType>)
+  static inline void computeBulk(const InputType* input, OutputType* output, std::size_t size, const args_t&,
+                                 Streams&... streams) {
+    if constexpr (sizeof...(Streams) == 0)
+      internal::convert_normalized_bulk(input, output, size);
+    else {
+      constexpr std::size_t chunk_size{1024};
+      std::array<least_float_t, chunk_size> noise;
+      for (std::size_t i{0}; i < size; i += chunk_size) {
+        const std::size_t count{std::min(chunk_size, size - i)};
+        (streams.next(noise.data(), count), ...);
+        internal::convert_normalized_bulk(input + i, output + i, count, noise.data());
+      }
+    }
+  }
 };
 } // namespace
-template<typename InputType, typename OutputType> using ConvertNode =
-    PerPixelOutNode<InputType, OutputType, ConvertCallable>;
+template<typename InputType, typename OutputType, template<typename, typename> typename Cache = internal::SpatialCache>
+using ConvertNode = PerPixelOutNode<InputType, OutputType, ConvertCallable, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct LinearCallable {
@@ -80,10 +126,25 @@ template<typename InputType, typename OutputType> struct LinearCallable {
     return convert_normalized<Dither, OutputType>(
         args.factor * convert_normalized<Dither, least_float_t>(input, rands...) + args.constant, rands...);
   }
+
+  /**
+   * Applies the linear function to chunks of floating point values, which is only used without dithering.
+   */
+  static inline void computeBulk(const InputType* input, OutputType* output, std::size_t size, const args_t& args)
+  requires internal::is_bulk_convertible_v<least_float_t, InputType> and
+      internal::is_bulk_convertible_v<OutputType, least_float_t> {
+    internal::transform_normalized_bulk<least_float_t>(
+        output, size,
+        [&](std::size_t count, least_float_t* values) {
+          for (std::size_t i{0}; i < count; ++i) values[i] = args.factor * values[i] + args.constant;
+        },
+        input);
+  }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>> using LinearNode =
-    PerPixelOutNode<InputType, OutputType, LinearCallable>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using LinearNode = PerPixelOutNode<InputType, OutputType, LinearCallable, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct GammaCallable {
@@ -105,10 +166,25 @@ template<typename InputType, typename OutputType> struct GammaCallable {
     return convert_normalized<Dither, OutputType>(
         std::pow(convert_normalized<Dither, least_float_t>(input, rands...), args.gamma), rands...);
   }
+
+  /**
+   * Applies the gamma correction to chunks of floating point values, which is only used without dithering.
+   */
+  static inline void computeBulk(const InputType* input, OutputType* output, std::size_t size, const args_t& args)
+  requires internal::is_bulk_convertible_v<least_float_t, InputType> and
+      internal::is_bulk_convertible_v<OutputType, least_float_t> {
+    internal::transform_normalized_bulk<least_float_t>(
+        output, size,
+        [&](std::size_t count, least_float_t* values) {
+          for (std::size_t i{0}; i < count; ++i) values[i] = std::pow(values[i], args.gamma);
+        },
+        input);
+  }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>> using GammaNode =
-    PerPixelOutNode<InputType, OutputType, GammaCallable>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using GammaNode = PerPixelOutNode<InputType, OutputType, GammaCallable, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct ClampCallable {
@@ -130,6 +206,7 @@ template<typename InputType, typename OutputType> struct ClampCallable {
   }
 };
 } // namespace
-template<typename InputType, typename OutputType = InputType> using ClampNode =
-    PerPixelOutNode<InputType, OutputType, ClampCallable>;
+template<typename InputType, typename OutputType = InputType,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using ClampNode = PerPixelOutNode<InputType, OutputType, ClampCallable, Cache>;
 } // namespace ImageGraph::nodes
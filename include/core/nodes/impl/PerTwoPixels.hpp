@@ -1,13 +1,17 @@
 #pragma once
+#include "../../../internal/typing/BulkConversion.hpp"
 #include "../MovingTime.hpp"
 
 namespace ImageGraph::nodes {
+/**
+ * @tparam Cache The cache type, which is also selectable through the aliases of the callables.
+ */
 template<typename InputType1, typename InputType2, typename OutputType,
-         template<typename In1, typename In2, typename Out> typename Callable>
-struct PerTwoPixelsOutNode final : public TiledCachedOutputNode<OutputType>,
+         template<typename In1, typename In2, typename Out> typename Callable,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+struct PerTwoPixelsOutNode final : public TiledCachedOutputNode<OutputType, Cache>,
                                    public MovingTimeInputOutputNode<OutputType, InputType1, InputType2> {
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
   using call_t = Callable<InputType1, InputType2, OutputType>;
   using args_t = typename call_t::args_t;
 
@@ -16,7 +20,14 @@ struct PerTwoPixelsOutNode final : public TiledCachedOutputNode<OutputType>,
 
 private:
   const args_t attributes_;
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
+
+  /**
+   * Whether the callable can compute whole arrays at once, which it signals by providing computeBulk.
+   */
+  template<typename... Streams> static constexpr bool is_bulk{
+      requires(const InputType1* in1, const InputType2* in2, OutputType* output, const args_t& args,
+               Streams&... streams) { call_t::computeBulk(in1, in2, output, std::size_t{}, args, streams...); }};
 
 protected:
   void computeImpl(std::tuple<const Tile<InputType1>&, const Tile<InputType2>&> inputs,
@@ -27,11 +38,16 @@ protected:
     assert(in1.rectangle() == in2.rectangle());
     assert(in1.size() == in2.size());
     std::size_t size{in1.size()};
-    if (this->generator_)
-      for (size_t i{0}; i < size; ++i)
-        output[i] = call_t::template compute<true>(in1[i], in2[i], attributes_, *this->generator_);
-    else
-      for (size_t i{0}; i < size; ++i) output[i] = call_t::template compute<false>(in1[i], in2[i], attributes_);
+    ditherer_.perform<least_float_t>(output, [&](auto&... stream) {
+      if constexpr (is_bulk<std::remove_reference_t<decltype(stream)>...>)
+        call_t::computeBulk(in1.data(), in2.data(), output.data(), size, attributes_, stream...);
+      else
+        // Both inputs might be dithered, so the streams have to be told the position.
+        for (size_t i{0}; i < size; ++i) {
+          internal::dither_seek(i, stream...);
+          output[i] = call_t::template compute<sizeof...(stream) != 0>(in1[i], in2[i], attributes_, stream...);
+        }
+    });
   }
 
   std::ostream& print(std::ostream& stream) const final {
@@ -42,7 +58,7 @@ protected:
            << ">(input 1=" << &this->template typedInputNode<0>()
            << ", input 2=" << &this->template typedInputNode<1>() << ", ";
     if (call_t::argumentNames(stream, attributes_)) stream << ", ";
-    stream << "dither=" << generator_.has_value();
+    stream << "dither=" << ditherer_.mode();
     return stream << ") @ " << this << "]";
   }
 
@@ -56,12 +72,12 @@ protected:
 
 public:
   template<typename... Args>
-  PerTwoPixelsOutNode(OutputNode<InputType1>& input1, OutputNode<InputType2>& input2, bool dither, Args&&... args)
+  PerTwoPixelsOutNode(OutputNode<InputType1>& input1, OutputNode<InputType2>& input2, internal::Ditherer dither,
+                      Args&&... args)
       : OutNode(input1.dimensions().bound(input2.dimensions()), std::max(input1.channels(), input2.channels()), 1,
                 internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputType1, InputType2>(std::make_tuple(&input1, &input2), false),
-        attributes_{std::forward<Args>(args)...}, generator_{dither ? std::optional<pcg_t>(pcg_t())
-                                                                    : std::optional<pcg_t>()} {}
+        attributes_{std::forward<Args>(args)...}, ditherer_{dither} {}
 };
 
 namespace {
@@ -87,10 +103,25 @@ template<typename In1, typename In2, typename Out> struct AdditionCallable {
     } else
       return convert_normalized<Dither, Out>(in1, rands...) + convert_normalized<Dither, Out>(in2, rands...);
   }
+
+  /**
+   * Computes the sums of chunks of native floating point outputs, which is only used without dithering.
+   */
+  static inline void computeBulk(const In1* in1, const In2* in2, Out* output, std::size_t size, const args_t&)
+  requires std::is_floating_point_v<Out> and internal::is_bulk_convertible_v<Out, In1> and
+      internal::is_bulk_convertible_v<Out, In2> {
+    internal::transform_normalized_bulk<Out>(
+        output, size,
+        [](std::size_t count, Out* values, const Out* others) {
+          for (std::size_t i{0}; i < count; ++i) values[i] += others[i];
+        },
+        in1, in2);
+  }
 };
 } // namespace
-template<typename In1, typename In2, typename Out> using AdditionNode =
-    PerTwoPixelsOutNode<In1, In2, Out, AdditionCallable>;
+template<typename In1, typename In2, typename Out,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using AdditionNode = PerTwoPixelsOutNode<In1, In2, Out, AdditionCallable, Cache>;
 
 namespace {
 template<typename In1, typename In2, typename Out> struct SubtractionCallable {
@@ -115,10 +146,25 @@ template<typename In1, typename In2, typename Out> struct SubtractionCallable {
     } else
       return convert_normalized<Dither, Out>(in1, rands...) - convert_normalized<Dither, Out>(in2, rands...);
   }
+
+  /**
+   * Computes the differences of chunks of native floating point outputs, which is only used without dithering.
+   */
+  static inline void computeBulk(const In1* in1, const In2* in2, Out* output, std::size_t size, const args_t&)
+  requires std::is_floating_point_v<Out> and internal::is_bulk_convertible_v<Out, In1> and
+      internal::is_bulk_convertible_v<Out, In2> {
+    internal::transform_normalized_bulk<Out>(
+        output, size,
+        [](std::size_t count, Out* values, const Out* others) {
+          for (std::size_t i{0}; i < count; ++i) values[i] -= others[i];
+        },
+        in1, in2);
+  }
 };
 } // namespace
-template<typename In1, typename In2, typename Out> using SubtractionNode =
-    PerTwoPixelsOutNode<In1, In2, Out, SubtractionCallable>;
+template<typename In1, typename In2, typename Out,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using SubtractionNode = PerTwoPixelsOutNode<In1, In2, Out, SubtractionCallable, Cache>;
 
 namespace {
 template<typename In1, typename In2, typename Out> struct MultiplicationCallable {
@@ -135,10 +181,25 @@ template<typename In1, typename In2, typename Out> struct MultiplicationCallable
                                                convert_normalized<Dither, least_float_t>(in2, rands...),
                                            rands...);
   }
+
+  /**
+   * Computes the products of chunks of floating point values, which is only used without dithering.
+   */
+  static inline void computeBulk(const In1* in1, const In2* in2, Out* output, std::size_t size, const args_t&)
+  requires internal::is_bulk_convertible_v<least_float_t, In1> and
+      internal::is_bulk_convertible_v<least_float_t, In2> and internal::is_bulk_convertible_v<Out, least_float_t> {
+    internal::transform_normalized_bulk<least_float_t>(
+        output, size,
+        [](std::size_t count, least_float_t* values, const least_float_t* others) {
+          for (std::size_t i{0}; i < count; ++i) values[i] *= others[i];
+        },
+        in1, in2);
+  }
 };
 } // namespace
-template<typename In1, typename In2, typename Out> using MultiplicationNode =
-    PerTwoPixelsOutNode<In1, In2, Out, MultiplicationCallable>;
+template<typename In1, typename In2, typename Out,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using MultiplicationNode = PerTwoPixelsOutNode<In1, In2, Out, MultiplicationCallable, Cache>;
 
 namespace {
 template<typename In1, typename In2, typename Out> struct DivisionCallable {
@@ -155,8 +216,23 @@ template<typename In1, typename In2, typename Out> struct DivisionCallable {
                                                convert_normalized<Dither, least_float_t>(in2, rands...),
                                            rands...);
   }
+
+  /**
+   * Computes the quotients of chunks of floating point values, which is only used without dithering.
+   */
+  static inline void computeBulk(const In1* in1, const In2* in2, Out* output, std::size_t size, const args_t&)
+  requires internal::is_bulk_convertible_v<least_float_t, In1> and
+      internal::is_bulk_convertible_v<least_float_t, In2> and internal::is_bulk_convertible_v<Out, least_float_t> {
+    internal::transform_normalized_bulk<least_float_t>(
+        output, size,
+        [](std::size_t count, least_float_t* values, const least_float_t* others) {
+          for (std::size_t i{0}; i < count; ++i) values[i] /= others[i];
+        },
+        in1, in2);
+  }
 };
 } // namespace
-template<typename In1, typename In2, typename Out> using DivisionNode =
-    PerTwoPixelsOutNode<In1, In2, Out, DivisionCallable>;
+template<typename In1, typename In2, typename Out,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using DivisionNode = PerTwoPixelsOutNode<In1, In2, Out, DivisionCallable, Cache>;
 } // namespace ImageGraph::nodes
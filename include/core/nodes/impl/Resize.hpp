@@ -1,35 +1,63 @@
 #pragma once
 #include "../../../internal/BicubicInterpolator.hpp"
+#include "../../../internal/CubicConvolution.hpp"
 #include "../../../internal/typing/NumberConversion.hpp"
 #include "../../../internal/typing/NumberTraits.hpp"
 #include "../MovingTime.hpp"
+#include "../OptimizedOutputNode.hpp"
+#include "Vips.hpp"
 #include <boost/math/constants/constants.hpp>
 #include <boost/math/special_functions/sinc.hpp>
 #include <optional>
 #include <type_traits>
 
 namespace ImageGraph::nodes {
-template<typename InputType, typename OutputType, typename Callable>
-struct ResizeNode : public TiledCachedOutputNode<OutputType>, public MovingTimeInputOutputNode<OutputType, InputType> {
+struct ResizeOutNode : virtual public OutNode {
+  /**
+   * A loader decoding at a reduced size and the node replacing the resize, which reads from it.
+   */
+  struct ShrunkLoad {
+    std::unique_ptr<OutNode> loader;
+    std::unique_ptr<OptimizedOutNode> replacement;
+  };
+
+  /**
+   * If the input is a LoadNode used by nothing else and its file can be shrunk while decoding, a loader with the
+   * largest possible shrink and a residual resize representing this node and the original loader are created.
+   * The caller has to add both to the graph.
+   * @return The created nodes or std::nullopt if the input cannot be shrunk.
+   */
+  virtual std::optional<ShrunkLoad> shrinkOnLoad() = 0;
+};
+
+template<typename InputType, typename OutputType, typename Callable, template<typename, typename> typename Cache>
+class ShrinkOnLoadResizeNode;
+
+/**
+ * @tparam Cache The cache type, which is also selectable through the aliases of the callables.
+ */
+template<typename InputType, typename OutputType, typename Callable,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+struct ResizeNode : public TiledCachedOutputNode<OutputType, Cache>,
+                    public MovingTimeInputOutputNode<OutputType, InputType>,
+                    public ResizeOutNode {
   using rectangle_t = Node::rectangle_t;
   using input_index_t = Node::input_index_t;
 
   using least_float_t = internal::least_floating_point_t<OutputType>;
-  using pcg_t = internal::pcg_fast_generator<least_float_t>;
   using args_t = typename Callable::args_t;
 
 private:
   const args_t attributes_;
   const least_float_t factor_x_, factor_y_;
   const std::size_t extension_;
-  mutable std::optional<pcg_t> generator_;
+  const internal::Ditherer ditherer_;
 
 protected:
   void computeImpl(std::tuple<const Tile<InputType>&> inputs, Tile<OutputType>& output) const final {
-    if (generator_.has_value())
-      return Callable::template compute<true, pcg_t>(std::get<0>(inputs), output, *this, *generator_);
-    else
-      return Callable::template compute<false>(std::get<0>(inputs), output, *this);
+    ditherer_.perform<least_float_t>(output, [&](auto&... stream) {
+      Callable::template compute<sizeof...(stream) != 0>(std::get<0>(inputs), output, *this, stream...);
+    });
   }
 
   rectangle_t rawInputRegion(input_index_t, rectangle_t out_rect) const final {
@@ -52,7 +80,7 @@ public:
     stream << "<" << type_name<InputType>() << ", " << type_name<OutputType>() << ">(factor_x=" << factor_x_
            << ", factor_y=" << factor_y_ << ", extension=" << extension_ << ", ";
     if (Callable::argumentNames(stream, attributes_)) stream << ", ";
-    stream << "dither=" << generator_.has_value();
+    stream << "dither=" << ditherer_.mode();
     stream << ") @ " << this << "]";
     return stream;
   }
@@ -60,20 +88,76 @@ public:
   least_float_t factorX() const { return factor_x_; }
   least_float_t factorY() const { return factor_y_; }
   const args_t& attributes() const { return attributes_; }
+  const internal::Ditherer& ditherer() const { return ditherer_; }
+
+  std::optional<ShrunkLoad> shrinkOnLoad() override;
 
   template<typename... Args> ResizeNode(OutputNode<InputType>& input, least_float_t factor_x_, least_float_t factor_y_,
-                                        bool dither, Args&&... args)
+                                        internal::Ditherer dither, Args&&... args)
       : OutNode({std::size_t(std::ceil(factor_x_ * input.width())), std::size_t(std::ceil(factor_y_ * input.height()))},
                 input.channels(), 1, internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
         InputOutNode<InputType>(input, false), attributes_{std::forward<Args>(args)...}, factor_x_{factor_x_},
-        factor_y_{factor_y_}, extension_{Callable::extension_(attributes_)}, generator_{
-                                                                                 dither ? std::optional<pcg_t>(pcg_t())
-                                                                                        : std::optional<pcg_t>()} {}
+        factor_y_{factor_y_}, extension_{Callable::extension_(attributes_)}, ditherer_{dither} {}
 };
 
+/**
+ * Replaces a LoadNode and the ResizeNode reading from it by a loader decoding at a reduced size followed by the
+ * remaining resize, which has the same dimensions as the original one.
+ */
+template<typename InputType, typename OutputType, typename Callable, template<typename, typename> typename Cache>
+class ShrinkOnLoadResizeNode final : public ResizeNode<InputType, OutputType, Callable, Cache>,
+                                     public OptimizedOutputNode<OutputType> {
+  using resize_t = ResizeNode<InputType, OutputType, Callable, Cache>;
+  using least_float_t = typename resize_t::least_float_t;
+
+  static inline least_float_t residualFactor(std::size_t target, std::size_t source) {
+    return least_float_t(double(target) / double(source));
+  }
+
+public:
+  std::ostream& print(std::ostream& stream) const final {
+    resize_t::print(stream << "[ShrinkOnLoadResizeNode(resize=");
+    return this->printChildren(stream << ", children={") << "}) @ " << this << "]";
+  }
+
+  std::optional<ResizeOutNode::ShrunkLoad> shrinkOnLoad() final { return std::nullopt; }
+
+  /**
+   * @param shrunk The loader decoding the file of loader at a reduced size.
+   * @param loader The original loader, which is only used by resize.
+   * @param resize The original resize.
+   */
+  ShrinkOnLoadResizeNode(LoadNode<InputType>& shrunk, LoadNode<InputType>& loader, resize_t& resize)
+      : OutNode(resize.dimensions(), resize.channels(), 1, internal::MemoryMode::ANY_MEMORY, typeid(OutputType)),
+        OptimizedOutNode({&loader, &resize}), InputOutNode<InputType>(shrunk, false),
+        resize_t(shrunk, residualFactor(resize.width(), shrunk.width()),
+                 residualFactor(resize.height(), shrunk.height()), resize.ditherer(), resize.attributes()),
+        OptimizedOutputNode<OutputType>(resize) {}
+};
+
+template<typename InputType, typename OutputType, typename Callable, template<typename, typename> typename Cache>
+std::optional<ResizeOutNode::ShrunkLoad> ResizeNode<InputType, OutputType, Callable, Cache>::shrinkOnLoad() {
+  constexpr least_float_t _1{1};
+
+  // Types which VIPS cannot load do not have a LoadNode.
+  if constexpr (not internal::has_band_format_v<InputType>)
+    return std::nullopt;
+  else {
+    auto loader{dynamic_cast<LoadNode<InputType>*>(&this->typedInputNode())};
+    if (not loader or loader->hasParents() or loader->successorCount() != 1 or loader->shrink() != 1)
+      return std::nullopt;
+    const std::size_t shrink{loader->maxShrink(std::size_t(_1 / std::max(factor_x_, factor_y_)))};
+    if (shrink <= 1) return std::nullopt;
+
+    auto shrunk{std::make_unique<LoadNode<InputType>>(loader->path(), shrink)};
+    auto replacement{
+        std::make_unique<ShrinkOnLoadResizeNode<InputType, OutputType, Callable, Cache>>(*shrunk, *loader, *this)};
+    return ShrunkLoad{std::move(shrunk), std::move(replacement)};
+  }
+}
+
 namespace {
 template<typename InputType, typename OutputType> struct NearestNeighbourComputer {
-  using node_t = ResizeNode<InputType, OutputType, NearestNeighbourComputer>;
   using least_float_t = internal::least_floating_point_t<OutputType>;
 
   using args_t = std::tuple<>;
@@ -83,8 +167,9 @@ template<typename InputType, typename OutputType> struct NearestNeighbourCompute
 
   static inline std::size_t extension_(const std::tuple<>&) { return 0; }
 
-  template<bool dither, typename... Args>
-  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const node_t& node, Args&... args) {
+  template<bool dither, typename NodeType, typename... Args>
+  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                      Args&... args) {
     constexpr least_float_t _1{1}, p5{.5};
 
     const auto channels{node.channels()};
@@ -104,12 +189,13 @@ template<typename InputType, typename OutputType> struct NearestNeighbourCompute
   }
 };
 } // namespace
-template<typename InputType, typename OutputType = InputType> using NearestNeighbourResizeNode =
-    ResizeNode<InputType, OutputType, NearestNeighbourComputer<InputType, OutputType>>;
+template<typename InputType, typename OutputType = InputType,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using NearestNeighbourResizeNode =
+    ResizeNode<InputType, OutputType, NearestNeighbourComputer<InputType, OutputType>, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct BilinearComputer {
-  using node_t = ResizeNode<InputType, OutputType, BilinearComputer>;
   using least_float_t = internal::least_floating_point_t<OutputType>;
 
   using args_t = std::tuple<>;
@@ -119,8 +205,9 @@ template<typename InputType, typename OutputType> struct BilinearComputer {
 
   static inline std::size_t extension_(const std::tuple<>&) { return 1; }
 
-  template<bool dither, typename... Args>
-  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const node_t& node, Args&... args) {
+  template<bool dither, typename NodeType, typename... Args>
+  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                      Args&... args) {
     using namespace internal;
     constexpr least_float_t _0{0}, _1{1}, p5{.5};
 
@@ -156,23 +243,87 @@ template<typename InputType, typename OutputType> struct BilinearComputer {
   }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>>
-using BilinearResizeNode = ResizeNode<InputType, OutputType, BilinearComputer<InputType, OutputType>>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using BilinearResizeNode = ResizeNode<InputType, OutputType, BilinearComputer<InputType, OutputType>, Cache>;
+
+/**
+ * CONVOLUTION uses the separable Keys (Catmull-Rom) kernel, SPLINE interpolates with bicubic splines,
+ * which is considerably slower.
+ */
+enum class BicubicMode { CONVOLUTION, SPLINE };
 
 namespace {
 template<typename InputType, typename OutputType> struct BicubicComputer {
-  using node_t = ResizeNode<InputType, OutputType, BicubicComputer>;
   using least_float_t = internal::least_floating_point_t<OutputType>;
 
-  using args_t = std::tuple<>;
+  struct ModeContainer {
+    const BicubicMode mode;
+    ModeContainer(BicubicMode mode = BicubicMode::CONVOLUTION) : mode{mode} {}
+  };
+  using args_t = ModeContainer;
 
   static inline std::ostream& nodeName(std::ostream& stream) { return stream << "BicubicResizeNode"; }
-  static inline bool argumentNames(std::ostream&, const args_t&) { return false; }
+  static inline bool argumentNames(std::ostream& stream, const args_t& attributes) {
+    stream << "mode=" << (attributes.mode == BicubicMode::CONVOLUTION ? "convolution" : "spline");
+    return true;
+  }
 
-  static inline std::size_t extension_(const std::tuple<>&) { return 2; }
+  static inline std::size_t extension_(const args_t&) { return 2; }
 
-  template<bool dither, typename... Args>
-  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const node_t& node, Args&... args) {
+  template<bool dither, typename NodeType, typename... Args>
+  static void computeConvolution(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                                 Args&... args) {
+    using namespace internal;
+    using axis_t = CubicConvolutionAxis<least_float_t>;
+    constexpr least_float_t _1{1};
+
+    const std::size_t channels{node.channels()};
+    const Rectangle in_rect{in_tile.rectangle()}, out_rect{out_tile.rectangle()};
+    const std::size_t in_width{in_rect.width()}, in_height{in_rect.height()}, out_width{out_rect.width()},
+        out_height{out_rect.height()}, in_line{in_width * channels}, out_line{out_width * channels};
+    const axis_t axis_x{out_rect.left(), out_width, _1 / node.factorX(), in_rect.left(), in_width},
+        axis_y{out_rect.top(), out_height, _1 / node.factorY(), in_rect.top(), in_height};
+
+    // Only the rows used by the vertical pass are filtered horizontally.
+    std::vector<bool> used_rows(in_height, false);
+    for (std::size_t y{0}; y < out_height; ++y)
+      for (std::size_t k{0}; k < axis_t::taps; ++k) used_rows[axis_y.indices(y)[k]] = true;
+
+    std::vector<least_float_t> row(in_line), horizontal(in_height * out_line);
+    for (std::size_t y{0}; y < in_height; ++y) {
+      if (not used_rows[y]) continue;
+      const InputType* input{in_tile.data() + y * in_line};
+      for (std::size_t i{0}; i < in_line; ++i) row[i] = convert_normalized<dither, least_float_t>(input[i], args...);
+
+      least_float_t* output{horizontal.data() + y * out_line};
+      for (std::size_t x{0}; x < out_width; ++x) {
+        const std::size_t* indices{axis_x.indices(x)};
+        const least_float_t* weights{axis_x.weights(x)};
+        const least_float_t *r0{row.data() + indices[0] * channels}, *r1{row.data() + indices[1] * channels},
+            *r2{row.data() + indices[2] * channels}, *r3{row.data() + indices[3] * channels};
+        for (std::size_t channel{0}; channel < channels; ++channel)
+          output[x * channels + channel] = weights[0] * r0[channel] + weights[1] * r1[channel] +
+                                           weights[2] * r2[channel] + weights[3] * r3[channel];
+      }
+    }
+
+    for (std::size_t y{0}; y < out_height; ++y) {
+      const std::size_t* indices{axis_y.indices(y)};
+      const least_float_t* weights{axis_y.weights(y)};
+      const least_float_t *r0{horizontal.data() + indices[0] * out_line},
+          *r1{horizontal.data() + indices[1] * out_line}, *r2{horizontal.data() + indices[2] * out_line},
+          *r3{horizontal.data() + indices[3] * out_line};
+      OutputType* output{out_tile.data() + y * out_line};
+      for (std::size_t i{0}; i < out_line; ++i)
+        output[i] = convert_normalized<dither, OutputType>(
+            weights[0] * r0[i] + weights[1] * r1[i] + weights[2] * r2[i] + weights[3] * r3[i], args...);
+    }
+  }
+
+  template<bool dither, typename NodeType, typename... Args>
+  static void computeSpline(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                            Args&... args) {
     using namespace internal;
     constexpr least_float_t _1{1}, p5{.5};
 
@@ -180,9 +331,10 @@ template<typename InputType, typename OutputType> struct BicubicComputer {
     const least_float_t inv_x{_1 / node.factorX()}, inv_y{_1 / node.factorY()};
     const Rectangle in_rect{in_tile.rectangle()}, out_rect{out_tile.rectangle()};
 
-    internal::BicubicInterpolator<InputType, least_float_t, Tile> interpolator{
-        in_tile,
+    const auto converter{
         [&args...](InputType input) { return convert_normalized<dither, least_float_t, InputType>(input, args...); }};
+    internal::BicubicInterpolator<InputType, least_float_t, Tile, decltype(converter)> interpolator{in_tile,
+                                                                                                     converter};
 
     for (std::size_t y{0}; y < out_rect.height(); ++y)
       for (std::size_t x{0}; x < out_rect.width(); ++x)
@@ -192,14 +344,23 @@ template<typename InputType, typename OutputType> struct BicubicComputer {
                                     inv_y * (y + out_rect.top() + p5) - p5 - in_rect.top(), channel),
               args...);
   }
+
+  template<bool dither, typename NodeType, typename... Args>
+  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                      Args&... args) {
+    if (node.attributes().mode == BicubicMode::SPLINE)
+      computeSpline<dither>(in_tile, out_tile, node, args...);
+    else
+      computeConvolution<dither>(in_tile, out_tile, node, args...);
+  }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>>
-using BicubicResizeNode = ResizeNode<InputType, OutputType, BicubicComputer<InputType, OutputType>>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using BicubicResizeNode = ResizeNode<InputType, OutputType, BicubicComputer<InputType, OutputType>, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct LanczosComputer {
-  using node_t = ResizeNode<InputType, OutputType, LanczosComputer>;
   using least_float_t = internal::least_floating_point_t<OutputType>;
 
   struct AContainer {
@@ -216,8 +377,9 @@ template<typename InputType, typename OutputType> struct LanczosComputer {
 
   static inline std::size_t extension_(const AContainer& c) { return c.a; }
 
-  template<bool dither, typename... Args>
-  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const node_t& node, Args&... args) {
+  template<bool dither, typename NodeType, typename... Args>
+  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                      Args&... args) {
     using namespace boost::math;
     using namespace internal;
     constexpr least_float_t _0{0}, _1{1}, p5{.5};
@@ -260,12 +422,12 @@ template<typename InputType, typename OutputType> struct LanczosComputer {
   }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>>
-using LanczosResizeNode = ResizeNode<InputType, OutputType, LanczosComputer<InputType, OutputType>>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using LanczosResizeNode = ResizeNode<InputType, OutputType, LanczosComputer<InputType, OutputType>, Cache>;
 
 namespace {
 template<typename InputType, typename OutputType> struct BlockComputer {
-  using node_t = ResizeNode<InputType, OutputType, BlockComputer>;
   using least_float_t = internal::least_floating_point_t<OutputType>;
 
   using args_t = std::tuple<>;
@@ -275,8 +437,9 @@ template<typename InputType, typename OutputType> struct BlockComputer {
 
   static inline std::size_t extension_(const std::tuple<>&) { return 0; }
 
-  template<bool dither, typename... Args>
-  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const node_t& node, Args&... args) {
+  template<bool dither, typename NodeType, typename... Args>
+  static void compute(const Tile<InputType>& in_tile, Tile<OutputType>& out_tile, const NodeType& node,
+                      Args&... args) {
     using namespace internal;
     constexpr least_float_t _0{0}, _1{1};
 
@@ -313,6 +476,7 @@ template<typename InputType, typename OutputType> struct BlockComputer {
   }
 };
 } // namespace
-template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>> using BlockResizeNode =
-    ResizeNode<InputType, OutputType, BlockComputer<InputType, OutputType>>;
+template<typename InputType, typename OutputType = internal::least_floating_point_t<InputType>,
+         template<typename, typename> typename Cache = internal::SpatialCache>
+using BlockResizeNode = ResizeNode<InputType, OutputType, BlockComputer<InputType, OutputType>, Cache>;
 } // namespace ImageGraph::nodes
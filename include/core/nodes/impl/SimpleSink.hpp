@@ -39,7 +39,7 @@ template<typename InputType> class SimpleSinkNode : public SinkNode {
         std::lock_guard guard{mutex_};
         results_.emplace_back(rect, std::move(result.future_tile));
       }
-      if (result.finished) return std::make_optional<RequiredTaskInfo>(node_.input_, rect);
+      if (result.finished) return std::make_optional<RequiredTaskInfo>(node_.input_.outputNode(), rect);
       return std::nullopt;
     }
 
@@ -47,7 +47,8 @@ template<typename InputType> class SimpleSinkNode : public SinkNode {
      * CAUTION This is only safe if the tiles do not overlap!
      */
     void performSingleImpl(const Node& node, rectangle_t rectangle) final {
-      DEBUG_ASSERT(std::invalid_argument, &node == &node_.input_, "The given node is not the stored node!");
+      DEBUG_ASSERT(std::invalid_argument, &node == &node_.input_.outputNode(),
+                   "The given node is not the stored node!");
       std::shared_ptr<Tile<InputType>> tile;
       {
         std::lock_guard guard{mutex_};
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "../../../internal/Json.hpp"
 #include "../../../internal/Typing.hpp"
 #include "../../Definitions.hpp"
 #include "../TiledInputOutputNode.hpp"
+#include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <memory>
+#include <string_view>
+#include <utility>
 #include <vips/vips8>
 
 namespace ImageGraph::nodes {
@@ -16,10 +21,62 @@ class UniqueVipsWrap {
 
   UniqueVipsWrap(VipsImage* image) : image_{image} {}
 
+  enum class ShrinkMode { NONE, POWER_OF_TWO, ANY };
+
+  /**
+   * JPEG can only be shrunk by 2, 4 or 8 while decoding, WebP by any factor.
+   * Other formats are decoded at full size.
+   */
+  static ShrinkMode shrinkMode(const std::string& path) {
+    static constexpr std::array<std::pair<std::string_view, ShrinkMode>, 2> loaders{
+        {{"jpegload", ShrinkMode::POWER_OF_TWO}, {"webpload", ShrinkMode::ANY}}};
+
+    const char* loader{vips_foreign_find_load(path.c_str())};
+    if (not loader) {
+      vips_error_clear();
+      return ShrinkMode::NONE;
+    }
+    // The type name of the loader is an implementation detail, while its nickname is the name of the operation.
+    const char* nickname{vips_nickname_find(g_type_from_name(loader))};
+    if (not nickname) return ShrinkMode::NONE;
+    auto it{std::find_if(loaders.begin(), loaders.end(),
+                         [nickname](const auto& entry) { return entry.first == nickname; })};
+    return it == loaders.end() ? ShrinkMode::NONE : it->second;
+  }
+
 public:
   static UniqueVipsWrap loadFromFile(const std::string& path) {
     return UniqueVipsWrap(vips_image_new_from_file(path.c_str(), nullptr));
   }
+  /**
+   * Decodes the file at a size reduced by the given factor, which has to be supported, see maxShrink.
+   */
+  static UniqueVipsWrap loadFromFile(const std::string& path, std::size_t shrink) {
+    if (shrink <= 1) return loadFromFile(path);
+    switch (shrinkMode(path)) {
+      case ShrinkMode::POWER_OF_TWO:
+        return UniqueVipsWrap(vips_image_new_from_file(path.c_str(), "shrink", int(shrink), nullptr));
+      case ShrinkMode::ANY:
+        return UniqueVipsWrap(vips_image_new_from_file(path.c_str(), "scale", 1. / double(shrink), nullptr));
+      case ShrinkMode::NONE: break;
+    }
+    throw std::invalid_argument("The file \"" + path + "\" cannot be shrunk while loading!");
+  }
+  /**
+   * @return The largest factor not exceeding limit by which the file can be shrunk while decoding.
+   */
+  static std::size_t maxShrink(const std::string& path, std::size_t limit) {
+    constexpr std::array<std::size_t, 3> powers{8, 4, 2};
+    switch (shrinkMode(path)) {
+      case ShrinkMode::POWER_OF_TWO: {
+        auto it{std::find_if(powers.begin(), powers.end(), [limit](std::size_t power) { return power <= limit; })};
+        return it == powers.end() ? 1 : *it;
+      }
+      case ShrinkMode::ANY: return std::max<std::size_t>(limit, 1);
+      case ShrinkMode::NONE: break;
+    }
+    return 1;
+  }
 
   UniqueVipsWrap(UniqueVipsWrap&& other) : image_{other.image_} { other.image_ = nullptr; }
   UniqueVipsWrap(const UniqueVipsWrap&) = delete;
@@ -58,9 +115,8 @@ protected:
 
   OutNode::duration_t tileDuration(Node::rectangle_t) const override { return {}; }
   void updateTileDuration(OutNode::duration_t, Node::rectangle_t) const override {}
-  std::size_t cacheSizeFromBytes(std::size_t) const override { return 0; }
 
-  void setCacheSize(std::size_t) const override {}
+  void setCacheBytes(std::size_t) const override {}
   std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const override { return nullptr; }
 
   rectangle_t rawInputRegion(input_index_t, rectangle_t) const final {
@@ -108,15 +164,33 @@ public:
 
 template<typename OutputType> class LoadNode final : public VipsInputOutputNode<OutputType> {
   std::string path_;
-  LoadNode(UniqueVipsWrap&& image, std::string&& path)
-      : __UNIQUE_VIPS_INIT_DEFAULT(), VipsInputOutputNode<OutputType>(std::move(image)), path_{std::move(path)} {}
+  std::size_t shrink_;
+  LoadNode(UniqueVipsWrap&& image, std::string&& path, std::size_t shrink)
+      : __UNIQUE_VIPS_INIT_DEFAULT(), VipsInputOutputNode<OutputType>(std::move(image)), path_{std::move(path)},
+        shrink_{shrink} {}
 
   std::ostream& print(std::ostream& stream) const final {
-    return stream << "[LoadNode<" << internal::type_name<OutputType>() << ">(path=\"" << path_ << "\") @ " << this
-                  << "]";
+    stream << "[LoadNode<" << internal::type_name<OutputType>() << ">(path=\"";
+    internal::writeEscaped(stream, path_);
+    stream << "\"";
+    if (shrink_ > 1) stream << ", shrink=" << shrink_;
+    return stream << ") @ " << this << "]";
   }
 
 public:
-  LoadNode(std::string path) : LoadNode(UniqueVipsWrap::loadFromFile(path), std::move(path)) {}
+  LoadNode(std::string path) : LoadNode(UniqueVipsWrap::loadFromFile(path), std::move(path), 1) {}
+  /**
+   * Decodes the file at a reduced size, which is much cheaper for formats supporting it.
+   * @param shrink The factor by which to shrink the image, which has to be supported, see maxShrink.
+   */
+  LoadNode(std::string path, std::size_t shrink)
+      : LoadNode(UniqueVipsWrap::loadFromFile(path, shrink), std::move(path), shrink) {}
+
+  const std::string& path() const { return path_; }
+  std::size_t shrink() const { return shrink_; }
+  /**
+   * @return The largest factor not exceeding limit by which this file can be shrunk while decoding.
+   */
+  std::size_t maxShrink(std::size_t limit) const { return UniqueVipsWrap::maxShrink(path_, limit); }
 };
 } // namespace ImageGraph::nodes
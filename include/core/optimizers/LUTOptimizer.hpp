@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../IndexedGraph.hpp"
+#include "../Metrics.hpp"
 #include "../NodeGraph.hpp"
 #include "../nodes/impl/LUTCombinator.hpp"
 #include <tuple>
@@ -16,18 +18,18 @@ template<typename SupportedTypes> class LUTOptimizer : public Optimizer {
   using l_u_t_nodes_t = std::unordered_set<std::shared_ptr<LUTOutNode>>;
   using optimized_t = std::unordered_set<std::unique_ptr<OptimizedOutNode>>;
 
-  struct CurrentDFSPath {
+  struct Chain {
     /**
      * Stores the nodes in reverse order, i.e. the first node in the chain comes last.
      */
     std::vector<LUTOutNode*> nodes;
 
-    CurrentDFSPath(std::vector<LUTOutNode*>&& nodes) : nodes{std::move(nodes)} {}
+    Chain(std::vector<LUTOutNode*>&& nodes) : nodes{std::move(nodes)} {}
   };
 
   struct CallHelper {
     template<typename OutputType, typename InputType>
-    static inline std::unique_ptr<OptimizedOutNode> perform(CurrentDFSPath& path) {
+    static inline std::unique_ptr<OptimizedOutNode> perform(Chain& path) {
       return std::make_unique<nodes::LUTCombinatorNode<OutputType, InputType>>(
           dynamic_cast<LUTInputOutNode<InputType>&>(*path.nodes.back()),
           std::unordered_set<OutNode*>(path.nodes.begin(), path.nodes.end()),
@@ -40,68 +42,66 @@ template<typename SupportedTypes> class LUTOptimizer : public Optimizer {
   };
 
   /**
-   * @return true if the path has been continued by node, false if not. If false, the path has to be
-   * added to an optimizer by the caller!
+   * @return The node as a LUT node if it is one which has not been replaced yet, otherwise nullptr.
    */
-  inline bool dfs_inner(OutNode& node, optimized_t& optimized_set, CurrentDFSPath* path) const {
+  static inline LUTOutNode* lutNode(Node& node) {
     auto l_u_t{dynamic_cast<LUTOutNode*>(&node)};
-    if (l_u_t) {
-      DEBUG_ASSERT(std::runtime_error, l_u_t->inputCount() == 1,
-                   "A LUT node has to have an output and precisely one input!");
+    return l_u_t and not l_u_t->hasParents() ? l_u_t : nullptr;
+  }
+  /**
+   * @return Whether the LUT node with the given index is part of the chain of its only successor.
+   */
+  static inline bool continues(const IndexedGraph& graph, IndexedGraph::index_t index) {
+    const auto& successors{graph.successors(index)};
+    return graph.outNode(index)->successorCount() == 1 and successors.size() == 1 and
+           lutNode(graph.node(successors.front()));
+  }
 
-      // A path can either be continued or newly constructed
-      CurrentDFSPath* new_path;
-      bool continued;
-      if (path and node.successorCount() == 1) {
-        // The path exists and can be continued.
-        new_path = path;
-        new_path->nodes.emplace_back(l_u_t);
-        continued = true;
-      } else {
-        // The path does not exists, but a new one can be created.
-        new_path = new CurrentDFSPath({l_u_t});
-        continued = false;
-      }
-      if (!dfs_inner(node.inputNode(0).outputNode(), optimized_set, new_path)) {
-        auto l_u_t_path{*new_path};
-        std::cout << "Working on path with length " << l_u_t_path.nodes.size() << ":" << std::endl;
-        while (not l_u_t_path.nodes.empty() and not SupportedTypes::template perform<LuttableCallable, bool>(
-                                                        l_u_t_path.nodes.back()->inputNode(0).outputType())
-                                                        .value()) {
-          l_u_t_path.nodes.pop_back();
-          std::cout << "Cut!" << std::endl;
-        }
-        if (!l_u_t_path.nodes.empty()) {
-          std::cout << "Remaining: " << l_u_t_path.nodes.size() << std::endl;
-          optimized_set.emplace(
-              internal::TypeListList<SupportedTypes, luttable_t>::template perform<CallHelper,
-                                                                                   std::unique_ptr<OptimizedOutNode>>(
-                  std::tie(l_u_t_path.nodes.front()->outputType(), l_u_t_path.nodes.back()->inputNode(0).outputType()),
-                  l_u_t_path)
-                  .value());
-        } else
-          std::cout << "All cut!" << std::endl;
-      }
-      if (continued)
-        new_path->nodes.pop_back();
-      else
-        delete new_path;
-      return continued;
-    } else {
-      // The node is not a LUT node at all, i.e. any potential path cannot be continued and an empty
-      // path is handed down.
-      const size_t input_count{node.inputCount()};
-      for (size_t i{0}; i < input_count; ++i) dfs_inner(node.inputNode(i).outputNode(), optimized_set, {});
-      return false;
+  /**
+   * Adds the optimized node of the chain, which is cut at its end until the input type is supported.
+   */
+  inline void build(Chain l_u_t_path, optimized_t& optimized_set) const {
+    const bool verbose{Metrics::verbose()};
+    if (verbose) std::cout << "Working on path with length " << l_u_t_path.nodes.size() << ":" << std::endl;
+    while (not l_u_t_path.nodes.empty() and not SupportedTypes::template perform<LuttableCallable, bool>(
+                                                    l_u_t_path.nodes.back()->inputNode(0).outputType())
+                                                    .value()) {
+      l_u_t_path.nodes.pop_back();
+      if (verbose) std::cout << "Cut!" << std::endl;
     }
+    if (!l_u_t_path.nodes.empty()) {
+      if (verbose) std::cout << "Remaining: " << l_u_t_path.nodes.size() << std::endl;
+      optimized_set.emplace(
+          internal::TypeListList<SupportedTypes, luttable_t>::template perform<CallHelper,
+                                                                               std::unique_ptr<OptimizedOutNode>>(
+              std::tie(l_u_t_path.nodes.front()->outputType(), l_u_t_path.nodes.back()->inputNode(0).outputType()),
+              l_u_t_path)
+              .value());
+    } else if (verbose)
+      std::cout << "All cut!" << std::endl;
   }
-  inline optimized_t dfs(const sink_nodes_t& sink_nodes) const {
+  /**
+   * Finds the maximal chains of LUT nodes in a single pass over the nodes reachable from the sinks, starting with the
+   * consumers, so that each chain is found once even if it is shared by several sinks.
+   * A chain starts at a LUT node which is not the only input of a LUT node and is continued by the input of its last
+   * node as long as that is a LUT node without other successors.
+   */
+  inline optimized_t chains(const sink_nodes_t& sink_nodes) const {
+    const IndexedGraph graph{sink_nodes};
     optimized_t optimized_set{};
-    for (const auto& node : sink_nodes) {
-      CurrentDFSPath path{{}};
-      const auto input_count{node->inputCount()};
-      for (size_t i{0}; i < input_count; ++i) dfs_inner(node->inputNode(i), optimized_set, &path);
-      std::cout << "path length: " << path.nodes.size() << std::endl;
+    for (IndexedGraph::index_t i{graph.size()}; i-- > 0;) {
+      LUTOutNode* first{lutNode(graph.node(i))};
+      if (not first or continues(graph, i)) continue;
+      Chain path{{first}};
+      for (IndexedGraph::index_t j{i};;) {
+        DEBUG_ASSERT(std::runtime_error, graph.inputs(j).size() == 1,
+                     "A LUT node has to have an output and precisely one input!");
+        const IndexedGraph::index_t input{graph.inputs(j).front()};
+        LUTOutNode* next{lutNode(graph.node(input))};
+        if (not next or next->successorCount() != 1) break;
+        path.nodes.push_back(next), j = input;
+      }
+      build(std::move(path), optimized_set);
     }
     return optimized_set;
   }
@@ -110,23 +110,32 @@ public:
   void operator()(NodeGraph& graph) const final {
     const sink_nodes_t& sink_nodes{graph.sinkNodes()};
 
-    auto optimized_set{dfs(sink_nodes)};
+    auto optimized_set{chains(sink_nodes)};
+    if (Metrics::enabled())
+      Metrics::global()
+          .counter("imagegraph_lut_chains_total", "The chains of LUT nodes combined into a single node.")
+          .add(double(optimized_set.size()));
 
-    std::cout << "sink_nodes: {" << std::endl;
-    for (const auto& node : sink_nodes) std::cout << "  " << *node << std::endl;
-    std::cout << "}" << std::endl;
+    const bool verbose{Metrics::verbose()};
+    if (verbose) {
+      std::cout << "sink_nodes: {" << std::endl;
+      for (const auto& node : sink_nodes) std::cout << "  " << *node << std::endl;
+      std::cout << "}" << std::endl;
 
-    std::cout << "optimized_set: {" << std::endl;
-    for (const auto& node : optimized_set) std::cout << "  " << *node << std::endl;
-    std::cout << "}" << std::endl;
+      std::cout << "optimized_set: {" << std::endl;
+      for (const auto& node : optimized_set) std::cout << "  " << *node << std::endl;
+      std::cout << "}" << std::endl;
+    }
 
     while (not optimized_set.empty()) graph.addOutNode(std::move(optimized_set.extract(optimized_set.begin()).value()));
 
-    std::cout << "graph.outNodes(): {" << std::endl;
-    const auto& out_nodes{graph.outNodes()};
-    for (const auto& node : out_nodes)
-      std::cout << "  [" << *node << ", " << node->successorCount() << "]" << std::endl;
-    std::cout << "}" << std::endl;
+    if (verbose) {
+      std::cout << "graph.outNodes(): {" << std::endl;
+      const auto& out_nodes{graph.outNodes()};
+      for (const auto& node : out_nodes)
+        std::cout << "  [" << *node << ", " << node->successorCount() << "]" << std::endl;
+      std::cout << "}" << std::endl;
+    }
   }
 };
 } // namespace ImageGraph::optimizers
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../IndexedGraph.hpp"
+#include "../NodeGraph.hpp"
+#include "../nodes/impl/Resize.hpp"
+#include <vector>
+
+namespace ImageGraph::optimizers {
+/**
+ * Fuses every LoadNode which only feeds a downscaling ResizeNode into a loader decoding at a reduced size and a
+ * residual resize. This saves decoding time and reduces the memory charged to the source node.
+ * Sinks are not counted as successors of their inputs, so the loader must not have any other successor in the
+ * IndexedGraph either.
+ */
+class ShrinkOnLoadOptimizer : public Optimizer {
+public:
+  void operator()(NodeGraph& graph) const final {
+    const IndexedGraph indexed{graph};
+    std::vector<nodes::ResizeOutNode::ShrunkLoad> shrunk_loads{};
+    for (const auto& node : graph.outNodes()) {
+      auto resize{dynamic_cast<nodes::ResizeOutNode*>(node.get())};
+      if (not resize or resize->hasParents() or indexed.successors(*indexed.index(resize->inputNode(0))).size() != 1)
+        continue;
+      if (auto shrunk_load{resize->shrinkOnLoad()}) shrunk_loads.push_back(std::move(*shrunk_load));
+    }
+
+    for (auto& [loader, replacement] : shrunk_loads) {
+      graph.addOutNode(std::move(loader));
+      graph.addOutNode(std::move(replacement));
+    }
+  }
+};
+} // namespace ImageGraph::optimizers
@@ -1,20 +1,37 @@
 #pragma once
 
+#include "../core/Metrics.hpp"
 #include "Mathematics.hpp"
+#include "PCG.hpp"
 #include "Random.hpp"
 #include <iomanip>
+#include <iostream>
+#include <limits>
 #include <memory>
-#include "PCG.hpp"
 #include <random>
-#include <set>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#include <vector>
 
 namespace ImageGraph::internal {
 template<typename Solution> class Annealer {
-  mutable pcg64 random_number_generator_{pcg_extras::seed_seq_from<std::random_device>()};
+  mutable pcg64 random_number_generator_;
+  bool verbose_{Metrics::verbose()};
 
 public:
   using cost_t = double;
 
+  Annealer() : random_number_generator_{pcg_extras::seed_seq_from<std::random_device>()} {}
+  /**
+   * Together with a seeded initial solution, this makes the result deterministic.
+   */
+  explicit Annealer(std::uint64_t seed) : random_number_generator_{seed} {}
+
+  /**
+   * Sets whether the costs of the proposals are printed.
+   */
+  void setVerbose(bool verbose) { verbose_ = verbose; }
+
   struct SolutionInfo {
     Solution solution;
     cost_t cost;
@@ -30,36 +47,68 @@ public:
     return cost_y <= cost_x ? 1 : std::exp(-(cost_y - cost_x) / temperature);
   }
 
-  SolutionInfo perform(Solution init, std::size_t end_iterations, cost_t initial_temp, cost_t beta, const std::size_t) {
+  /**
+   * Performs simulated annealing, evaluating the costs of thread_num proposals concurrently:
+   * The proposals are neighbours of the current solution generated in order, which are then considered in order until
+   * one is accepted, discarding the rest. As the sequential annealer also proposes neighbours of the current solution
+   * until one is accepted, the trajectory is the same for any number of threads, only the unused proposals are wasted.
+   * @param end_iterations The number of iterations without improvement after which the optimum is returned.
+   * @param thread_num The number of proposals whose costs are computed concurrently, where 0 uses all cores.
+   */
+  SolutionInfo perform(Solution init, std::size_t end_iterations, cost_t initial_temp, cost_t beta,
+                       std::size_t thread_num) {
     using shared_t = std::shared_ptr<Solution>;
+    if (not thread_num) thread_num = std::size_t(tbb::this_task_arena::max_concurrency());
+    tbb::task_arena arena{int(thread_num)};
+
     shared_t x{std::make_shared<Solution>(std::move(init))};
     cost_t cost_x{x->cost()};
-    std::cout << std::setprecision(std::numeric_limits<cost_t>::digits10);
-    std::cout << "initial cost: " << cost_x << std::endl;
+    if (verbose_) {
+      std::cout << std::setprecision(std::numeric_limits<cost_t>::digits10);
+      std::cout << "initial cost: " << cost_x << std::endl;
+    }
 
     shared_t optimum{x};
     cost_t cost_optimum{cost_x};
     cost_t t{initial_temp};
 
-    std::size_t optimum_kept_counter{0};
+    std::vector<shared_t> proposals(thread_num);
+    std::vector<cost_t> costs(thread_num);
+    std::size_t optimum_kept_counter{0}, iterations{0}, acceptances{0};
     while (optimum_kept_counter <= end_iterations) {
-      shared_t y{std::make_shared<Solution>(x->random_neighbour())};
-      cost_t cost_y{y->cost()};
-      std::cout << "y cost " << cost_y << ": ";
-      const cost_t metropolis_value{metropolis(cost_x, cost_y, t)},
-          random_value{random_norm<cost_t>(random_number_generator_)};
-      if (metropolis_value >= random_value) {
-        x = std::move(y), cost_x = cost_y;
-        std::cout << "accepted!" << std::endl;
-      } else
-        std::cout << "rejected!" << std::endl;
-      t *= beta;
-      if (cost_optimum > cost_x)
-        optimum = x, cost_optimum = cost_x, optimum_kept_counter = 0;
-      else
-        ++optimum_kept_counter;
+      for (auto& proposal : proposals) proposal = std::make_shared<Solution>(x->random_neighbour());
+      arena.execute([&] {
+        tbb::parallel_for(std::size_t{0}, thread_num, [&](std::size_t i) { costs[i] = proposals[i]->cost(); });
+      });
+
+      for (std::size_t i{0}; i < thread_num and optimum_kept_counter <= end_iterations; ++i) {
+        if (verbose_) std::cout << "y cost " << costs[i] << ": ";
+        const cost_t metropolis_value{metropolis(cost_x, costs[i], t)},
+            random_value{random_norm<cost_t>(random_number_generator_)};
+        const bool accepted{metropolis_value >= random_value};
+        ++iterations;
+        if (accepted) {
+          ++acceptances;
+          x = std::move(proposals[i]), cost_x = costs[i];
+          if (verbose_) std::cout << "accepted!" << std::endl;
+        } else if (verbose_)
+          std::cout << "rejected!" << std::endl;
+        t *= beta;
+        if (cost_optimum > cost_x)
+          optimum = x, cost_optimum = cost_x, optimum_kept_counter = 0;
+        else
+          ++optimum_kept_counter;
+        if (accepted) break;
+      }
     }
 
+    if (Metrics::enabled()) {
+      Metrics& metrics{Metrics::global()};
+      metrics.counter("imagegraph_annealing_iterations_total", "The proposals considered by the annealer.")
+          .add(double(iterations));
+      metrics.counter("imagegraph_annealing_acceptances_total", "The proposals accepted by the annealer.")
+          .add(double(acceptances));
+    }
     return {std::move(*optimum), cost_optimum};
   }
 };
@@ -3,8 +3,6 @@
 #include "../core/SizedArray.hpp"
 #include "typing/NumberTraits.hpp"
 #include <functional>
-#include <gsl/gsl_linalg.h>
-#include <gsl/gsl_vector.h>
 #include <memory>
 #include <stdexcept>
 #include <vector>
@@ -78,9 +76,12 @@ public:
 /**
  * This implementation assumes a regular grid with distance 1, where the coordinates are given as
  * std::size_t.
+ * @tparam Converter Converts each input sample, which should be a lambda in hot paths to allow inlining.
  */
-template<typename InputType, typename OutputType, template<typename> typename TileType> class BicubicInterpolator {
-  using convert_t = std::function<OutputType(InputType)>;
+template<typename InputType, typename OutputType, template<typename> typename TileType,
+         typename Converter = std::function<OutputType(InputType)>>
+class BicubicInterpolator {
+  using convert_t = Converter;
 
   const convert_t converter_;
   const TileType<InputType>& tile_;
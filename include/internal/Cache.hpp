@@ -7,9 +7,14 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace ImageGraph::internal {
+/**
+ * A cache synchronized by a single mutex, whose capacity and size are given in the number of bytes occupied by the
+ * values as determined by byteSize, e.g. Tile::size() * sizeof(T) for tiles.
+ */
 template<typename K, typename V, typename Data, typename Proto> struct Cache {
   using key_type = K;
   using mapped_type = V;
@@ -47,11 +52,15 @@ public:
 
   std::unique_ptr<Proto> toProtoCache() const {
     Proto proto_cache{capacity()};
-    for (const auto& [key, value] : data_) proto_cache.put(key);
+    for (const auto& [key, value] : data_) proto_cache.put(key, byteSize(*value));
     return std::make_unique<Proto>(std::move(proto_cache));
   }
 
-  explicit Cache(size_t capacity) : data_{capacity} {}
+  /**
+   * @param args Further arguments of the data, e.g. the weight function of a GreedyDualMap.
+   */
+  template<typename... Args> explicit Cache(size_t capacity, Args&&... args)
+      : data_{capacity, std::forward<Args>(args)...} {}
   explicit Cache() : Cache(0) {}
 
   friend std::ostream& operator<<(std::ostream& stream, const Cache& cache) {
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "GreedyDualCache.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * Manages the entries of all ManagedCaches using a single byte budget, which is the sum of the budgets of the caches.
+ * Instead of evicting within the cache whose entry is put, the entry of any cache with the lowest value is evicted,
+ * where the value of an entry is the number of its uses times the cost of recomputing it per byte, which ages using
+ * GreedyDual-Size-Frequency. This way, memory shifts to the nodes whose entries are used in the current phase.
+ * Since any entry may be evicted by any put, all caches share a single mutex, which every get and put locks, so that
+ * concurrent lookups of different nodes serialize, unlike with separate caches. CacheBenchmark measures this cost.
+ * @tparam K The key type of the caches.
+ */
+template<typename K> class CacheManager {
+public:
+  using owner_t = const void*;
+  using weight_t = double;
+
+private:
+  using key_t = std::pair<owner_t, K>;
+  using index_t = GreedyDualIndex<key_t, std::shared_ptr<void>, true>;
+  struct Owner {
+    std::size_t budget{0};
+    std::size_t count{0};
+    std::size_t bytes{0};
+  };
+
+  mutable std::mutex mutex_{};
+  // The budget is enforced by makeRoom, which keeps track of the owners of evicted entries.
+  index_t index_{std::numeric_limits<std::size_t>::max()};
+  absl::flat_hash_map<owner_t, Owner> owners_{};
+  std::size_t budget_{0};
+
+  /**
+   * Evicts entries with the lowest values until the given number of bytes fits. The mutex has to be locked.
+   */
+  void makeRoom(std::size_t bytes) {
+    while (index_.size() and index_.used() + bytes > budget_) {
+      auto [key, size]{index_.evict()};
+      Owner& owner{owners_.find(key.first)->second};
+      --owner.count, owner.bytes -= size;
+    }
+  }
+
+public:
+  /**
+   * The manager is never destroyed, as caches may be destroyed after static destruction.
+   */
+  static CacheManager& global() {
+    static CacheManager* manager{new CacheManager};
+    return *manager;
+  }
+
+  std::size_t budget() const {
+    std::lock_guard lock{mutex_};
+    return budget_;
+  }
+  std::size_t used() const {
+    std::lock_guard lock{mutex_};
+    return index_.used();
+  }
+
+  /**
+   * Sets the number of bytes the owner adds to the budget.
+   */
+  void setBudget(owner_t owner, std::size_t bytes) {
+    std::lock_guard lock{mutex_};
+    Owner& data{owners_[owner]};
+    budget_ = budget_ - data.budget + bytes;
+    data.budget = bytes;
+    makeRoom(0);
+  }
+  /**
+   * Removes the entries and the budget of the owner.
+   */
+  void release(owner_t owner) {
+    const auto entries{this->entries(owner)};
+    std::lock_guard lock{mutex_};
+    for (const auto& entry : entries) index_.erase({owner, entry.first});
+    if (auto it{owners_.find(owner)}; it != owners_.end()) {
+      budget_ -= it->second.budget;
+      owners_.erase(it);
+    }
+    makeRoom(0);
+  }
+
+  std::size_t budget(owner_t owner) const {
+    std::lock_guard lock{mutex_};
+    auto it{owners_.find(owner)};
+    return it == owners_.end() ? 0 : it->second.budget;
+  }
+  std::size_t count(owner_t owner) const {
+    std::lock_guard lock{mutex_};
+    auto it{owners_.find(owner)};
+    return it == owners_.end() ? 0 : it->second.count;
+  }
+  std::size_t bytes(owner_t owner) const {
+    std::lock_guard lock{mutex_};
+    auto it{owners_.find(owner)};
+    return it == owners_.end() ? 0 : it->second.bytes;
+  }
+  /**
+   * @return The keys of the owner and the numbers of bytes of their values, starting with the next one to be evicted.
+   */
+  std::vector<std::pair<K, std::size_t>> entries(owner_t owner) const {
+    std::vector<std::pair<K, std::size_t>> output{};
+    std::lock_guard lock{mutex_};
+    index_.forEach([&](const key_t& key, const std::shared_ptr<void>&, std::size_t bytes) {
+      if (key.first == owner) output.emplace_back(key.second, bytes);
+    });
+    return output;
+  }
+
+  std::shared_ptr<void> get(owner_t owner, const K& key) {
+    std::lock_guard lock{mutex_};
+    auto value{index_.find({owner, key})};
+    return value ? *value : nullptr;
+  }
+  /**
+   * @param weight The cost of recomputing the value per byte.
+   * @param bytes The number of bytes occupied by the value.
+   */
+  void put(owner_t owner, const K& key, std::shared_ptr<void> value, weight_t weight, std::size_t bytes) {
+    std::lock_guard lock{mutex_};
+    const key_t index_key{owner, key};
+    Owner& data{owners_[owner]};
+    if (auto size{index_.erase(index_key)}) --data.count, data.bytes -= *size;
+    if (bytes > budget_) return;
+    makeRoom(bytes);
+    index_.insert(index_key, std::move(value), weight, bytes);
+    ++data.count, data.bytes += bytes;
+  }
+};
+
+/**
+ * A cache whose entries are managed by the global CacheManager together with those of all other ManagedCaches.
+ * Its capacity is the number of bytes it adds to the common budget, which it may exceed while other caches are cold.
+ * @tparam K The key type.
+ * @tparam V The value type, whose size in bytes is determined by byteSize.
+ */
+template<typename K, typename V> class ManagedCache {
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using weight_t = typename CacheManager<K>::weight_t;
+  using weight_function_t = std::function<weight_t(const K&)>;
+
+private:
+  CacheManager<K>& manager_;
+  weight_function_t weight_function_;
+
+public:
+  std::size_t capacity() const { return manager_.budget(this); }
+  std::size_t size() const { return manager_.bytes(this); }
+  void resize(std::size_t bytes) { manager_.setBudget(this, bytes); }
+
+  std::shared_ptr<V> get(const K& key) { return std::static_pointer_cast<V>(manager_.get(this, key)); }
+  std::shared_ptr<V> getSynchronized(const K& key) { return get(key); }
+
+  void put(const K& key, std::shared_ptr<V> ptr) {
+    const weight_t weight{weight_function_ ? weight_function_(key) : weight_t{1}};
+    const std::size_t size{byteSize(*ptr)};
+    manager_.put(this, key, std::move(ptr), weight, size);
+  }
+  void put(const K& key, V&& value) { put(key, std::make_shared<V>(std::move(value))); }
+  void putSynchronized(const K& key, std::shared_ptr<V> ptr) { put(key, std::move(ptr)); }
+  void putSynchronized(const K& key, V&& value) { put(key, std::move(value)); }
+
+  /**
+   * The planner simulates the share of each node as a separate cache using the same weights.
+   */
+  std::unique_ptr<GreedyDualProtoCache<K>> toProtoCache() const {
+    const auto entries{manager_.entries(this)};
+    auto proto_cache{std::make_unique<GreedyDualProtoCache<K>>(manager_.bytes(this), weight_function_)};
+    for (const auto& [key, bytes] : entries) proto_cache->put(key, bytes);
+    return proto_cache;
+  }
+
+  ManagedCache(std::size_t bytes, weight_function_t weight_function, CacheManager<K>& manager)
+      : manager_{manager}, weight_function_{std::move(weight_function)} {
+    resize(bytes);
+  }
+  explicit ManagedCache(std::size_t bytes, weight_function_t weight_function = {})
+      : ManagedCache(bytes, std::move(weight_function), CacheManager<K>::global()) {}
+  explicit ManagedCache() : ManagedCache(0) {}
+  ManagedCache(const ManagedCache&) = delete;
+  ~ManagedCache() { manager_.release(this); }
+};
+} // namespace ImageGraph::internal
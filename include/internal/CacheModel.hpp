@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ProtoGraphAdaptor.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <optional>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * Estimates the cost of every distribution of the cache bytes from a single simulation by a ProtoGraphAdaptor:
+ * The requests of a node are those of the sinks plus those of its consumers, each of which requests as much per
+ * computation as in the simulation, and its computations are its requests times its miss ratio at its number of
+ * bytes, which is read from its stack distance profile. Evaluating a distribution is thus a single pass over the
+ * nodes, starting with the consumers.
+ * As the request streams of the inputs change with the distribution, the model is accurate close to the simulated
+ * distribution, so it should be rebuilt from a simulation of the chosen distribution until the result is stable.
+ */
+class CacheModel {
+public:
+  using durrep_t = ProtoGraphAdaptor::durrep_t;
+  using weight_t = ProtoGraphAdaptor::weight_t;
+  using profile_t = ProtoGraphAdaptor::profile_t;
+
+  /**
+   * The estimated requests and computations of a node, weighted by the relevances of the sinks causing them.
+   */
+  struct Usage {
+    weight_t requests{0}, computations{0};
+  };
+
+private:
+  struct Node {
+    profile_t profile;
+    weight_t sink_requests;
+    // The duration of a computation, excluding those of the inputs.
+    durrep_t duration;
+    // The factor correcting the miss ratios of the profile, e.g. by the measured one.
+    weight_t miss_factor{1};
+    // The indices of the inputs and the number of requests per computation.
+    std::vector<std::pair<std::size_t, weight_t>> inputs{};
+    Node(profile_t profile, weight_t sink_requests, durrep_t duration)
+        : profile{std::move(profile)}, sink_requests{sink_requests}, duration{duration} {}
+  };
+
+  // Every node comes before its inputs.
+  std::vector<Node> nodes_{};
+  absl::flat_hash_map<const OutNode*, std::size_t> indices_{};
+  durrep_t weighted_sink_duration_;
+  // The factor making the weighted durations comparable to those of a ProtoGraphAdaptor.
+  weight_t normalization_{0};
+
+public:
+  /**
+   * @param adaptor The adaptor, which has to have simulated all sink tasks and finished its profiles.
+   */
+  explicit CacheModel(const ProtoGraphAdaptor& adaptor);
+
+  std::size_t size() const { return nodes_.size(); }
+  /**
+   * @return The index of the node, which is not given if it was never requested in the simulation.
+   */
+  std::optional<std::size_t> index(const OutNode& node) const {
+    auto it{indices_.find(&node)};
+    return it == indices_.end() ? std::nullopt : std::optional<std::size_t>{it->second};
+  }
+
+  /**
+   * Corrects the node by measured behaviour: Its miss ratios are multiplied by the given factor and the duration of a
+   * computation is replaced if given. Nodes which were never requested in the simulation are ignored.
+   */
+  void calibrate(const OutNode& node, weight_t miss_factor, std::optional<durrep_t> duration);
+
+  /**
+   * @param capacities The number of cache bytes of each node, by index.
+   * @param usages Set to the estimated usage of each node, by index.
+   * @return The estimated cost, which is comparable to that of the simulation.
+   */
+  durrep_t cost(const std::vector<std::size_t>& capacities, std::vector<Usage>& usages) const;
+};
+} // namespace ImageGraph::internal
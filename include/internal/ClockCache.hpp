@@ -0,0 +1,398 @@
+#pragma once
+
+#include "EpochReclaimer.hpp"
+#include "LRUCache.hpp"
+#include "ProtoCache.hpp"
+#include <absl/hash/hash.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * A concurrent cache which is split into shards by the hash of the keys and evicts using CLOCK (second chance).
+ * Each shard is an open addressing table in a flat array, in which a key is stored within a small window of slots
+ * after its home slot. Readers do not take any lock: They compare an atomic tag of the hash, and only if it matches,
+ * they load the immutable entry of the slot and copy its value. Hits set the reference bit of the slot instead of
+ * reordering a list. Writers lock the mutex of their shard, which evicts entries until the bytes of its entries fit
+ * into its share of the capacity and doubles its table once it is half full.
+ * Since the slots in a window are not shifted on removal, a reader may miss an entry which is being replaced, which
+ * only causes a recomputation, but it never returns a value for a different key.
+ *
+ * Replaced entries are deleted using epoch-based reclamation instead of using std::atomic<std::shared_ptr>, which
+ * libstdc++ implements using a lock, so that lookups stay lock-free. Their values are therefore released a little later
+ * than they are evicted. Whether this scales better than the locking caches has to be measured using CacheBenchmark on
+ * a machine with as many cores as compute threads.
+ * @tparam K The key type, which has to be hashable by absl::Hash.
+ * @tparam V The value type.
+ */
+template<typename K, typename V> class ClockCache {
+public:
+  using key_type = K;
+  using mapped_type = V;
+
+  /** The number of slots after the home slot of a key in which it may be stored. */
+  static constexpr std::size_t window{8};
+  static constexpr std::size_t max_shards{16};
+
+private:
+  struct Entry {
+    const K key;
+    const std::shared_ptr<V> value;
+    const std::size_t bytes;
+  };
+  struct Slot {
+    // Zero if the slot is empty, otherwise the hash of the key with the lowest bit set.
+    std::atomic<std::uint64_t> tag{0};
+    std::atomic<bool> referenced{false};
+    // The entry, which is only replaced by the writers of the shard and retired once it has been replaced.
+    std::atomic<Entry*> entry{nullptr};
+
+    /**
+     * @return The value if the slot contains the given key, which requires the reader to be protected by a guard.
+     */
+    std::shared_ptr<V> load(const K& key) const {
+      const Entry* current{entry.load(std::memory_order_acquire)};
+      return current and current->key == key ? current->value : nullptr;
+    }
+  };
+  /**
+   * The slots of a shard, which are replaced by a larger table and then retired. The entries are owned by the slots of
+   * the current table, to which a larger table moves them, so deleting a table does not delete its entries.
+   */
+  struct Table {
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    explicit Table(std::size_t slot_count) : slots{std::make_unique<Slot[]>(slot_count)}, mask{slot_count - 1} {}
+  };
+  struct Shard {
+    EpochReclaimer* reclaimer{nullptr};
+    std::mutex mutex{};
+    // The current table, which is owned by the shard.
+    std::atomic<Table*> table{nullptr};
+    // The maximum number of bytes, the number of entries and the number of bytes of the entries.
+    std::size_t limit{0};
+    std::atomic<std::size_t> count{0}, bytes{0};
+    std::size_t hand{0};
+
+    ~Shard() { delete table.load(std::memory_order_relaxed); }
+
+    Table& current() const { return *table.load(std::memory_order_relaxed); }
+    /**
+     * Replaces the table, retiring the old one, as readers may still use it.
+     */
+    void publish(std::unique_ptr<Table> new_table) {
+      reclaimer->retire(table.exchange(new_table.release(), std::memory_order_acq_rel));
+    }
+
+    void clear(Slot& slot) {
+      if (not slot.tag.load(std::memory_order_relaxed)) return;
+      slot.tag.store(0, std::memory_order_release);
+      Entry* entry{slot.entry.exchange(nullptr)};
+      count.fetch_sub(1, std::memory_order_relaxed);
+      bytes.fetch_sub(entry->bytes, std::memory_order_relaxed);
+      slot.referenced.store(false, std::memory_order_relaxed);
+      reclaimer->retire(entry);
+    }
+    void set(Slot& slot, std::uint64_t tag, const K& key, std::shared_ptr<V> value, std::size_t size) {
+      clear(slot);
+      slot.entry.store(new Entry{key, std::move(value), size}, std::memory_order_release);
+      count.fetch_add(1, std::memory_order_relaxed);
+      bytes.fetch_add(size, std::memory_order_relaxed);
+      slot.tag.store(tag, std::memory_order_release);
+    }
+
+    /**
+     * Removes the first entry from the hand on whose reference bit is not set, clearing the bits on the way.
+     * @return Whether an entry has been removed.
+     */
+    bool evictOne() {
+      Table& t{current()};
+      for (std::size_t step{0}; step < 2 * (t.mask + 1); ++step, hand = (hand + 1) & t.mask) {
+        Slot& slot{t.slots[hand]};
+        if (not slot.tag.load(std::memory_order_relaxed)) continue;
+        if (slot.referenced.exchange(false, std::memory_order_relaxed)) continue;
+        clear(slot);
+        hand = (hand + 1) & t.mask;
+        return true;
+      }
+      return false;
+    }
+  };
+  struct State {
+    std::unique_ptr<Shard[]> shards;
+    std::size_t shard_count;
+    std::size_t capacity;
+
+    /**
+     * @param capacity The maximum number of bytes, which is split evenly among the shards.
+     * @param expected_bytes The expected number of bytes of an entry, which determines the number of shards.
+     */
+    State(EpochReclaimer& reclaimer, std::size_t capacity, std::size_t expected_bytes)
+        : shards{}, shard_count{std::bit_floor(
+                        std::clamp<std::size_t>(capacity / std::max<std::size_t>(expected_bytes, 1) / (2 * window),
+                                                1, max_shards))},
+          capacity{capacity} {
+      shards = std::make_unique<Shard[]>(shard_count);
+      for (std::size_t i{0}; i < shard_count; ++i) {
+        Shard& shard{shards[i]};
+        shard.reclaimer = &reclaimer;
+        shard.limit = capacity / shard_count + (i < capacity % shard_count);
+        shard.publish(std::make_unique<Table>(2 * window));
+      }
+    }
+  };
+
+  // Deletes the replaced entries, tables and shards once no reader can use them anymore.
+  mutable EpochReclaimer reclaimer_{};
+  /*
+   * The current shards, which are read without reference counting, as the counter would be shared by all readers.
+   * Replaced shards are therefore emptied and retired.
+   */
+  std::atomic<State*> state_;
+  std::mutex resize_mutex_{};
+  // Whether the shards have been created with the size of an actual entry.
+  std::atomic<bool> sized_{false};
+
+  static inline std::uint64_t hash(const K& key) { return absl::Hash<K>{}(key); }
+  static inline std::uint64_t tag(std::uint64_t hash) { return hash | 1; }
+  static inline Shard& shard(State& state, std::uint64_t hash) { return state.shards[hash % state.shard_count]; }
+  // The tag contains the same upper bits as the hash, so it can be used to move entries to a larger table.
+  static inline std::size_t home(const Table& table, std::uint64_t hash) { return (hash >> 32) & table.mask; }
+
+  /**
+   * Moves the entries of the table to the larger one, whose slots take over their ownership.
+   * @return Whether every entry fits into its window.
+   */
+  static bool rehash(const Table& from, Table& to) {
+    for (std::size_t i{0}; i <= from.mask; ++i) {
+      const Slot& slot{from.slots[i]};
+      const std::uint64_t slot_tag{slot.tag.load(std::memory_order_relaxed)};
+      if (not slot_tag) continue;
+      const std::size_t first{home(to, slot_tag)};
+      std::size_t j{0};
+      for (; j < window; ++j) {
+        Slot& target{to.slots[(first + j) & to.mask]};
+        if (target.tag.load(std::memory_order_relaxed)) continue;
+        target.entry.store(slot.entry.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        target.referenced.store(slot.referenced.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        target.tag.store(slot_tag, std::memory_order_relaxed);
+        break;
+      }
+      if (j == window) return false;
+    }
+    return true;
+  }
+  /**
+   * Moves the entries of the shard to a table with at least twice as many slots, doubling it again if an entry does not
+   * fit into its window. The mutex of the shard has to be locked.
+   */
+  static void grow(Shard& s) {
+    const Table& old_table{s.current()};
+    std::unique_ptr<Table> new_table{};
+    for (std::size_t slot_count{2 * (old_table.mask + 1)};; slot_count *= 2) {
+      new_table = std::make_unique<Table>(slot_count);
+      if (rehash(old_table, *new_table)) break;
+    }
+    s.publish(std::move(new_table));
+    s.hand = 0;
+  }
+
+  static void insert(State& state, const K& key, std::shared_ptr<V> value, std::size_t size) {
+    const std::uint64_t h{hash(key)}, t{tag(h)};
+    Shard& s{shard(state, h)};
+    std::lock_guard guard{s.mutex};
+    if (size > s.limit) return;
+
+    {
+      Table& table{s.current()};
+      const std::size_t first{home(table, h)};
+      for (std::size_t i{0}; i < window; ++i) {
+        Slot& slot{table.slots[(first + i) & table.mask]};
+        // The entry is only replaced while holding the lock of the shard, so it can be read without a guard.
+        if (slot.tag.load(std::memory_order_relaxed) != t) continue;
+        if (slot.entry.load(std::memory_order_relaxed)->key == key) {
+          s.clear(slot);
+          break;
+        }
+      }
+    }
+    while (s.bytes.load(std::memory_order_relaxed) + size > s.limit and s.evictOne()) {}
+    if (2 * (s.count.load(std::memory_order_relaxed) + 1) > s.current().mask + 1) grow(s);
+
+    Table& table{s.current()};
+    const std::size_t first{home(table, h)};
+    Slot* victim{nullptr};
+    for (std::size_t i{0}; i < window and not(victim and not victim->tag.load(std::memory_order_relaxed)); ++i) {
+      Slot& slot{table.slots[(first + i) & table.mask]};
+      if (not slot.tag.load(std::memory_order_relaxed))
+        victim = &slot;
+      else if (not victim and not slot.referenced.load(std::memory_order_relaxed))
+        victim = &slot;
+    }
+    // The window is full, so one of its entries is replaced, preferring those without a second chance.
+    s.set(victim ? *victim : table.slots[first], t, key, std::move(value), size);
+  }
+
+  /**
+   * Calls the functor with the key, value and bytes of every entry, which is not synchronized with concurrent writers.
+   * The caller has to hold a guard of the reclaimer.
+   */
+  template<typename F> static void forEach(State& state, F functor) {
+    for (std::size_t i{0}; i < state.shard_count; ++i) {
+      Table& table{*state.shards[i].table.load(std::memory_order_acquire)};
+      for (std::size_t j{0}; j <= table.mask; ++j)
+        if (const Entry* entry{table.slots[j].entry.load(std::memory_order_acquire)})
+          functor(entry->key, entry->value, entry->bytes);
+    }
+  }
+
+  /**
+   * Replaces the shards, keeping as many entries as fit into the new capacity. The resize mutex has to be locked.
+   */
+  void rebuild(std::size_t capacity, std::size_t expected_bytes) {
+    {
+      const auto guard{reclaimer_.guard()};
+      State& old_state{*state_.load(std::memory_order_relaxed)};
+      auto new_state{std::make_unique<State>(reclaimer_, capacity, expected_bytes)};
+      forEach(old_state, [&new_state](const K& key, const std::shared_ptr<V>& value, std::size_t bytes) {
+        insert(*new_state, key, value, bytes);
+      });
+      state_.store(new_state.release(), std::memory_order_release);
+      for (std::size_t i{0}; i < old_state.shard_count; ++i) {
+        Shard& shard{old_state.shards[i]};
+        std::lock_guard shard_guard{shard.mutex};
+        Table& table{shard.current()};
+        for (std::size_t j{0}; j <= table.mask; ++j) shard.clear(table.slots[j]);
+        shard.limit = 0;
+      }
+      reclaimer_.retire(&old_state);
+    }
+    reclaimer_.reclaim();
+  }
+
+public:
+  /**
+   * @return The maximum number of bytes.
+   */
+  std::size_t capacity() const {
+    const auto guard{reclaimer_.guard()};
+    return state_.load(std::memory_order_acquire)->capacity;
+  }
+  /**
+   * @return The number of bytes of the entries.
+   */
+  std::size_t size() const {
+    const auto guard{reclaimer_.guard()};
+    State* state{state_.load(std::memory_order_acquire)};
+    std::size_t output{0};
+    for (std::size_t i{0}; i < state->shard_count; ++i)
+      output += state->shards[i].bytes.load(std::memory_order_relaxed);
+    return output;
+  }
+  /**
+   * Replaces the shards, keeping as many entries as fit into the new capacity.
+   * Entries which are put concurrently may be lost.
+   */
+  void resize(std::size_t capacity) {
+    std::lock_guard guard{resize_mutex_};
+    const State& old_state{*state_.load(std::memory_order_relaxed)};
+    if (old_state.capacity == capacity) return;
+    std::size_t count{0}, bytes{0};
+    for (std::size_t i{0}; i < old_state.shard_count; ++i) {
+      count += old_state.shards[i].count.load(std::memory_order_relaxed);
+      bytes += old_state.shards[i].bytes.load(std::memory_order_relaxed);
+    }
+    rebuild(capacity, count ? bytes / count : capacity);
+  }
+
+  std::shared_ptr<V> get(const K& key) {
+    const auto guard{reclaimer_.guard()};
+    State* state{state_.load(std::memory_order_acquire)};
+    const std::uint64_t h{hash(key)}, t{tag(h)};
+    Table& table{*shard(*state, h).table.load(std::memory_order_acquire)};
+    const std::size_t first{home(table, h)};
+    for (std::size_t i{0}; i < window; ++i) {
+      Slot& slot{table.slots[(first + i) & table.mask]};
+      if (slot.tag.load(std::memory_order_acquire) != t) continue;
+      auto value{slot.load(key)};
+      if (not value) continue;
+      // Avoid writing to the cache line if the bit is already set.
+      if (not slot.referenced.load(std::memory_order_relaxed)) slot.referenced.store(true, std::memory_order_relaxed);
+      return value;
+    }
+    return nullptr;
+  }
+  std::shared_ptr<V> getSynchronized(const K& key) { return get(key); }
+
+  /**
+   * The first entry determines the number of shards, as the capacity alone does not tell how many entries fit.
+   */
+  void put(const K& key, std::shared_ptr<V> ptr) {
+    const std::size_t bytes{byteSize(*ptr)};
+    if (not sized_.load(std::memory_order_acquire)) {
+      std::lock_guard guard{resize_mutex_};
+      if (not sized_.load(std::memory_order_relaxed)) {
+        rebuild(state_.load(std::memory_order_relaxed)->capacity, bytes);
+        sized_.store(true, std::memory_order_release);
+      }
+    }
+    {
+      const auto guard{reclaimer_.guard()};
+      insert(*state_.load(std::memory_order_acquire), key, std::move(ptr), bytes);
+    }
+    reclaimer_.reclaim();
+  }
+  void put(const K& key, V&& value) { put(key, std::make_shared<V>(std::move(value))); }
+  void putSynchronized(const K& key, std::shared_ptr<V> ptr) { put(key, std::move(ptr)); }
+  void putSynchronized(const K& key, V&& value) { put(key, std::move(value)); }
+
+  std::unique_ptr<ClockProtoCache<K>> toProtoCache() const {
+    const auto guard{reclaimer_.guard()};
+    State* state{state_.load(std::memory_order_acquire)};
+    auto proto_cache{std::make_unique<ClockProtoCache<K>>(state->capacity)};
+    forEach(*state, [&proto_cache](const K& key, const std::shared_ptr<V>&, std::size_t bytes) {
+      proto_cache->put(key, bytes);
+    });
+    return proto_cache;
+  }
+
+  /**
+   * @param capacity The maximum number of bytes.
+   */
+  explicit ClockCache(std::size_t capacity) : state_{new State(reclaimer_, capacity, capacity)} {}
+  explicit ClockCache() : ClockCache(0) {}
+  ClockCache(const ClockCache&) = delete;
+  ClockCache& operator=(const ClockCache&) = delete;
+  /**
+   * Deletes the entries of the current tables, which own them, while the replaced tables only point to them.
+   */
+  ~ClockCache() {
+    State* state{state_.load(std::memory_order_relaxed)};
+    for (std::size_t i{0}; i < state->shard_count; ++i) {
+      Table& table{state->shards[i].current()};
+      for (std::size_t j{0}; j <= table.mask; ++j) delete table.slots[j].entry.load(std::memory_order_relaxed);
+    }
+    delete state;
+  }
+
+  friend std::ostream& operator<<(std::ostream& stream, const ClockCache& cache) {
+    stream << "[";
+    bool first{true};
+    const auto print{[&](const K& key, const std::shared_ptr<V>& value, std::size_t) {
+      if (not first) stream << ", ";
+      first = false;
+      stream << "(" << key << ": " << *value << ")";
+    }};
+    const auto guard{cache.reclaimer_.guard()};
+    forEach(*cache.state_.load(std::memory_order_acquire), print);
+    return stream << "]";
+  }
+};
+} // namespace ImageGraph::internal
@@ -29,8 +29,8 @@ struct transform_reducer {
   template<typename... TupleTypes>
   constexpr static inline T calc(const std::tuple<TupleTypes...>& tuple, Args&&... args) {
     return BinaryCallable::call(
-        transform_reducer<T, BinaryCallable, UnaryCallable, Index - 1, TupleTypes...>(tuple, args...),
-        UnaryCallable::call(std::get<Index>(tuple)));
+        transform_reducer<T, BinaryCallable, UnaryCallable, Index - 1, Args...>::calc(tuple, args...),
+        UnaryCallable::call(std::get<Index>(tuple), args...));
   }
 };
 template<typename T, typename BinaryCallable, typename UnaryCallable, typename... Args>
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "typing/NumberTraits.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * The taps of the Keys cubic convolution kernel with a = -1/2 (i.e. Catmull-Rom) along one axis, precomputed for
+ * every output coordinate. The indices are relative to the input and clamped to it, i.e. the border is replicated.
+ */
+template<typename T> requires is_floating_point_v<T> class CubicConvolutionAxis {
+public:
+  static constexpr std::size_t taps{4};
+
+private:
+  std::vector<std::size_t> indices_;
+  std::vector<T> weights_;
+
+public:
+  /**
+   * @param t The position relative to the second tap, which has to be in [0, 1].
+   * @return The weights of the four taps, which sum up to 1.
+   */
+  static inline std::array<T, taps> weights(T t) {
+    constexpr T _1{1}, _2{2}, p5{.5}, _1p5{1.5}, _2p5{2.5};
+    return {((-p5 * t + _1) * t - p5) * t, (_1p5 * t - _2p5) * t * t + _1, ((-_1p5 * t + _2) * t + p5) * t,
+            (p5 * t - p5) * t * t};
+  }
+
+  /**
+   * @param output_start The first output coordinate.
+   * @param output_size The number of output coordinates.
+   * @param scale The input distance between two neighbouring output coordinates.
+   * @param input_start The first input coordinate.
+   * @param input_size The number of input coordinates, which has to be positive.
+   */
+  CubicConvolutionAxis(std::size_t output_start, std::size_t output_size, T scale, std::size_t input_start,
+                       std::size_t input_size)
+      : indices_(taps * output_size), weights_(taps * output_size) {
+    constexpr T p5{.5};
+    using index_t = std::ptrdiff_t;
+
+    const index_t last{index_t(input_size) - 1};
+    for (std::size_t i{0}; i < output_size; ++i) {
+      const T position{scale * (T(output_start + i) + p5) - p5 - T(input_start)}, floor{std::floor(position)};
+      const index_t base{index_t(floor) - 1};
+      const auto tap_weights{weights(position - floor)};
+      for (std::size_t k{0}; k < taps; ++k) {
+        indices_[taps * i + k] = std::size_t(std::clamp<index_t>(base + index_t(k), 0, last));
+        weights_[taps * i + k] = tap_weights[k];
+      }
+    }
+  }
+
+  std::size_t size() const { return indices_.size() / taps; }
+  const std::size_t* indices(std::size_t i) const { return indices_.data() + taps * i; }
+  const T* weights(std::size_t i) const { return weights_.data() + taps * i; }
+};
+} // namespace ImageGraph::internal
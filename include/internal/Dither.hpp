@@ -0,0 +1,239 @@
+#pragma once
+
+#include "Random.hpp"
+#include "Typing.hpp"
+#include "typing/NumberTraits.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * How a node dithers when converting between types.
+ * NONE rounds to the nearest value, RANDOM adds uniform noise and ORDERED adds the threshold of a Bayer matrix
+ * indexed by the absolute pixel position, which is deterministic and cheaper than RANDOM.
+ */
+enum class DitherMode { NONE, RANDOM, ORDERED };
+static inline std::ostream& operator<<(std::ostream& stream, const DitherMode& mode) {
+  switch (mode) {
+    case DitherMode::NONE: return stream << "NONE";
+    case DitherMode::RANDOM: return stream << "RANDOM";
+    case DitherMode::ORDERED: return stream << "ORDERED";
+  }
+  return stream;
+}
+
+/**
+ * The dither noise used while computing one tile.
+ * The generator is seeded from the seed of the node and the position of the tile, so the noise does not depend on the
+ * thread computing the tile or on the order in which the tiles are computed. The uniforms are generated in blocks of
+ * one row of the tile, which are consumed in order.
+ */
+template<typename T> requires is_floating_point_v<T> class RandomDitherStream {
+  using pcg_t = pcg_fast_generator<T>;
+  using result_t = typename pcg_t::result_type;
+
+  pcg_t generator_;
+  std::vector<T> row_;
+  std::size_t index_;
+
+  /**
+   * Mixes the seed of the node with the position of the tile using the finalizer of SplitMix64, so that neighbouring
+   * tiles get unrelated streams.
+   */
+  static inline std::uint64_t tileSeed(std::uint64_t seed, std::size_t left, std::size_t top) {
+    constexpr auto mix{[](std::uint64_t z) {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+    }};
+    return mix(mix(mix(seed) ^ std::uint64_t(left)) ^ std::uint64_t(top));
+  }
+
+  void fill() {
+    constexpr int digits{std::numeric_limits<T>::digits}, bits{std::numeric_limits<result_t>::digits};
+    static_assert(digits < bits, "The generator does not produce enough bits!");
+    constexpr T factor{T(1) / T(result_t(1) << digits)};
+    for (auto& value : row_) value = factor * T(generator_() >> (bits - digits));
+    index_ = 0;
+  }
+
+public:
+  /**
+   * @param seed The seed of the node.
+   * @param left The left coordinate of the tile.
+   * @param top The top coordinate of the tile.
+   * @param row_size The number of samples in one row of the tile, which has to be positive.
+   */
+  RandomDitherStream(std::uint64_t seed, std::size_t left, std::size_t top, std::size_t row_size)
+      : generator_(tileSeed(seed, left, top)), row_(row_size), index_{row_size} {}
+
+  /**
+   * @return A uniformly distributed value in [0, 1).
+   */
+  T next() {
+    if (index_ == row_.size()) fill();
+    return row_[index_++];
+  }
+  /**
+   * Writes the next size values into output.
+   */
+  void next(T* output, std::size_t size) {
+    while (size > 0) {
+      if (index_ == row_.size()) fill();
+      const std::size_t count{std::min(size, row_.size() - index_)};
+      std::copy_n(row_.data() + index_, count, output);
+      index_ += count;
+      output += count;
+      size -= count;
+    }
+  }
+
+  /**
+   * The noise does not depend on the position within the tile, so this does nothing.
+   */
+  void seek(std::size_t) {}
+};
+
+template<typename N, typename T> static inline N random_real(RandomDitherStream<T>& stream, N min, N max) {
+  return min + (max - min) * N(stream.next());
+}
+
+template<typename N, typename T> static inline N random_norm(RandomDitherStream<T>& stream) {
+  return N(stream.next());
+}
+
+/**
+ * The thresholds of an 8×8 Bayer matrix for the samples of one tile.
+ * The samples are assumed to be consumed in the order in which they are stored in the tile, with one threshold per
+ * sample. Nodes which do not convert every sample exactly once in this order have to call seek before converting.
+ * As the matrix is indexed by the absolute position, the pattern is continuous across tiles.
+ */
+template<typename T> requires is_floating_point_v<T> class OrderedDitherStream {
+  static constexpr std::size_t order{8};
+  static constexpr std::array<T, order * order> thresholds_{[] {
+    std::array<T, order * order> thresholds{};
+    for (std::size_t y{0}; y < order; ++y)
+      for (std::size_t x{0}; x < order; ++x) {
+        // Interleave the bits of x ^ y and y and reverse them.
+        std::size_t value{0};
+        for (std::size_t bit{0}, mask{order >> 1}; mask; ++bit, mask >>= 1)
+          value |= std::size_t((x ^ y) & mask ? 1 : 0) << (2 * bit + 1) | std::size_t(y & mask ? 1 : 0) << (2 * bit);
+        thresholds[order * y + x] = (T(value) + T(.5)) / T(order * order);
+      }
+    return thresholds;
+  }()};
+
+  const std::size_t left_, top_, width_, channels_;
+  std::size_t x_{0}, y_{0}, channel_{0};
+
+public:
+  /**
+   * @param left The left coordinate of the tile.
+   * @param top The top coordinate of the tile.
+   * @param width The width of the tile.
+   * @param channels The number of channels of the tile.
+   */
+  OrderedDitherStream(std::size_t left, std::size_t top, std::size_t width, std::size_t channels)
+      : left_{left}, top_{top}, width_{std::max<std::size_t>(width, 1)},
+        channels_{std::max<std::size_t>(channels, 1)} {}
+
+  /**
+   * @return The threshold of the current sample, which is in (0, 1).
+   */
+  T next() {
+    const T threshold{thresholds_[order * ((top_ + y_) % order) + (left_ + x_) % order]};
+    if (++channel_ == channels_) {
+      channel_ = 0;
+      if (++x_ == width_) {
+        x_ = 0;
+        ++y_;
+      }
+    }
+    return threshold;
+  }
+  /**
+   * Writes the thresholds of the next size samples into output.
+   */
+  void next(T* output, std::size_t size) {
+    for (std::size_t i{0}; i < size; ++i) output[i] = next();
+  }
+
+  /**
+   * Continues at the sample with the given index within the tile.
+   */
+  void seek(std::size_t index) {
+    channel_ = index % channels_;
+    const std::size_t pixel{index / channels_};
+    x_ = pixel % width_;
+    y_ = pixel / width_;
+  }
+};
+
+/**
+ * Intermediate conversions to floating point types are not dithered, as only the final quantization has a threshold.
+ */
+template<typename N, typename T> static inline N random_real(OrderedDitherStream<T>&, N min, N max) {
+  return (min + max) / N(2);
+}
+
+template<typename N, typename T> static inline N random_norm(OrderedDitherStream<T>& stream) {
+  return N(stream.next());
+}
+
+/**
+ * Calls seek on all given streams, which is a no-op without dithering, in which case the index is unused.
+ */
+template<typename... Streams>
+static inline void dither_seek([[maybe_unused]] std::size_t index, Streams&... streams) {
+  (streams.seek(index), ...);
+}
+
+/**
+ * The dither mode of a node and the seed of its random noise.
+ * It is implicitly constructible from a bool, which selects RANDOM or NONE, and from a DitherMode. In both cases, the
+ * seed is chosen randomly.
+ */
+class Ditherer {
+  DitherMode mode_;
+  std::uint64_t seed_;
+
+  static inline std::uint64_t randomSeed() {
+    std::random_device device{};
+    return std::uint64_t(device()) << 32 | device();
+  }
+
+public:
+  Ditherer(bool dither) : Ditherer(dither ? DitherMode::RANDOM : DitherMode::NONE) {}
+  Ditherer(DitherMode mode) : Ditherer(mode, mode == DitherMode::RANDOM ? randomSeed() : 0) {}
+  Ditherer(DitherMode mode, std::uint64_t seed) : mode_{mode}, seed_{seed} {}
+
+  DitherMode mode() const { return mode_; }
+  bool isEnabled() const { return mode_ != DitherMode::NONE; }
+
+  /**
+   * Calls the callable with the dither stream of the given tile if dithering is enabled and without arguments
+   * otherwise.
+   * @tparam T The floating point type of the noise.
+   * @param tile The output tile, of which only the position, the width and the number of channels are used.
+   */
+  template<typename T, typename Tile, typename Callable>
+  decltype(auto) perform(const Tile& tile, Callable&& callable) const {
+    switch (mode_) {
+      case DitherMode::RANDOM: {
+        RandomDitherStream<T> stream(seed_, tile.left(), tile.top(),
+                                     std::max<std::size_t>(tile.width() * tile.channels(), 1));
+        return callable(stream);
+      }
+      case DitherMode::ORDERED: {
+        OrderedDitherStream<T> stream(tile.left(), tile.top(), tile.width(), tile.channels());
+        return callable(stream);
+      }
+      default: return callable();
+    }
+  }
+};
+} // namespace ImageGraph::internal
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * Epoch-based reclamation of objects which readers access without locking: A reader announces itself in a counter of
+ * the current epoch while it uses the objects, and an object which has been unlinked by a writer is retired and only
+ * deleted once the epoch has advanced twice. The epoch only advances once no reader of the previous epoch is left, so
+ * no reader which could still see the object is left either.
+ * Announcing is lock-free, as it only increments one of a few padded counters, which are shared by the threads hashed
+ * to them, while retiring and advancing take a mutex and are meant for writers.
+ */
+class EpochReclaimer {
+  static constexpr std::size_t stripe_count{16};
+
+  struct alignas(64) Counter {
+    std::atomic<std::size_t> value{0};
+  };
+  struct Retired {
+    void* object;
+    void (*deleter)(void*);
+  };
+
+  std::atomic<std::size_t> epoch_{0};
+  // The number of readers in each stripe which have entered in an epoch of the given parity.
+  std::array<std::array<Counter, stripe_count>, 2> readers_{};
+  std::mutex mutex_{};
+  // The objects retired in the current epoch and in the previous one, indexed by the parity of the epoch.
+  std::array<std::vector<Retired>, 2> retired_{};
+
+  static std::size_t stripe() {
+    static thread_local const std::size_t index{std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+                                                stripe_count};
+    return index;
+  }
+  static void destroy(std::vector<Retired>& retired) {
+    for (const auto& [object, deleter] : retired) deleter(object);
+    retired.clear();
+  }
+
+  bool idle(std::size_t parity) const {
+    for (const Counter& counter : readers_[parity])
+      if (counter.value.load()) return false;
+    return true;
+  }
+  /**
+   * The epoch is checked again after incrementing the counter, as the reader would not be waited for if the epoch
+   * advanced in between.
+   */
+  Counter& enter() {
+    const std::size_t index{stripe()};
+    for (;;) {
+      const std::size_t epoch{epoch_.load()};
+      Counter& counter{readers_[epoch & 1][index]};
+      counter.value.fetch_add(1);
+      if (epoch_.load() == epoch) return counter;
+      counter.value.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+public:
+  /**
+   * Protects the objects reachable by the reader while it exists.
+   */
+  class Guard {
+    Counter& counter_;
+
+  public:
+    explicit Guard(EpochReclaimer& reclaimer) : counter_{reclaimer.enter()} {}
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    ~Guard() { counter_.value.fetch_sub(1, std::memory_order_release); }
+  };
+
+  Guard guard() { return Guard{*this}; }
+
+  /**
+   * Deletes the object once no reader can access it anymore, which has to be unlinked before.
+   */
+  template<typename T> void retire(T* object) {
+    if (not object) return;
+    std::lock_guard lock{mutex_};
+    retired_[epoch_.load(std::memory_order_relaxed) & 1].push_back(
+        {object, [](void* pointer) { delete static_cast<T*>(pointer); }});
+  }
+  /**
+   * Advances the epoch if no reader of the previous epoch is left, deleting the objects retired in it.
+   * This does not block: If another thread is reclaiming or readers are left, nothing is done.
+   */
+  void reclaim() {
+    std::unique_lock lock{mutex_, std::try_to_lock};
+    if (not lock or (retired_[0].empty() and retired_[1].empty())) return;
+    const std::size_t epoch{epoch_.load(std::memory_order_relaxed)}, previous{(epoch + 1) & 1};
+    if (not idle(previous)) return;
+    // The objects of the previous epoch are deleted without holding the lock, as deleting values may take a while.
+    std::vector<Retired> deletable{std::exchange(retired_[previous], {})};
+    epoch_.store(epoch + 1);
+    lock.unlock();
+    destroy(deletable);
+  }
+
+  EpochReclaimer() = default;
+  EpochReclaimer(const EpochReclaimer&) = delete;
+  EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+  ~EpochReclaimer() {
+    for (auto& retired : retired_) destroy(retired);
+  }
+};
+} // namespace ImageGraph::internal
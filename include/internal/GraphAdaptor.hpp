@@ -58,6 +58,7 @@ public:
 
   bool empty() const { return set_.empty(); }
   bool emptyPerformable() const { return performable_.empty(); }
+  std::size_t performableCount() const { return performable_.size(); }
   bool emptyRequestable() const { return out_requestable_.empty() and chooser_.empty(); }
 
   TaskWrapper frontRequestable() {
@@ -79,15 +80,20 @@ public:
   /**
    * @tparam T The output type of the node.
    * @param caller The calling task.
-   * @param node The input node of which the given region shall be computed.
+   * @param requested The input node of which the given region shall be computed.
+   *                  If it has been replaced by an optimized node, the latter is used instead.
    * @param region The input region to be computed.
    * @return A std::shared_future representing the given region of the given node.
    *         This can come from a cache, another task or a new task.
    */
-  template<typename T> GeneratedTile<T> generateRegion(Task& caller, const OutputNode<T>& node, rectangle_t region) {
+  template<typename T>
+  GeneratedTile<T> generateRegion(Task& caller, const OutputNode<T>& requested, rectangle_t region) {
+    const OutputNode<T>& node{requested.hasParents() ? requested.typedOutputNode() : requested};
     if (node.memoryMode() == MemoryMode::ANY_MEMORY) {
       shared_tile_t<T> cache_tile{node.cacheGetSynchronized(region)};
       if (cache_tile) {
+        node.countRequest(true, false);
+        if (Trace::enabled()) Trace::instant("hit", node, region);
         std::promise<shared_tile_t<T>> promise{};
         promise.set_value(cache_tile);
         return {promise.get_future().share(), true};
@@ -99,6 +105,8 @@ public:
 
     TypedTask<shared_tile_t<T>>* ptr{task.get()};
     auto [it, inserted]{set_.emplace(std::move(task))};
+    node.countRequest(false, inserted);
+    if (Trace::enabled()) Trace::instant(inserted ? "generate" : "join", node, region);
     if (inserted) {
       ptr->addDependant(caller);
 
@@ -133,7 +141,10 @@ public:
     return deque;
   }
 
-  GraphAdaptor() = default;
+  /**
+   * @param first_tiles The number of tiles of every sink which are requested before any sink requests more.
+   */
+  explicit GraphAdaptor(std::size_t first_tiles = 0) : chooser_{first_tiles} {}
   GraphAdaptor(const GraphAdaptor&) = delete;
   GraphAdaptor(GraphAdaptor&&) = default;
 
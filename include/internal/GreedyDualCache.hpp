@@ -0,0 +1,266 @@
+#pragma once
+
+#include "Cache.hpp"
+#include "ProtoCache.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ImageGraph::internal {
+/**
+ * A map evicting using GreedyDual-Size: Each entry has a priority which is set to the inflation plus its weight, i.e.
+ * the cost of recomputing it divided by its size, whenever it is inserted or used. The entry with the lowest priority
+ * is evicted, and its priority becomes the new inflation, so that entries which are not used age.
+ * Ties are broken by recency, so with equal weights this evicts the least recently used entry.
+ * The capacity limits the sum of the sizes of the entries, each of which is 1 unless given otherwise.
+ * @tparam K The key type.
+ * @tparam Value The type of the stored values.
+ * @tparam CountUses Whether the weight is multiplied by the number of uses of the entry (GreedyDual-Size-Frequency).
+ */
+template<typename K, typename Value, bool CountUses = false> class GreedyDualIndex {
+  template<typename, typename, bool> friend class GreedyDualIndex;
+
+public:
+  using weight_t = double;
+
+private:
+  using priority_t = std::pair<weight_t, std::uint64_t>;
+  using queue_t = std::map<priority_t, K>;
+  struct Entry {
+    typename queue_t::iterator position;
+    weight_t weight;
+    std::size_t size;
+    std::uint64_t uses;
+    Value value;
+  };
+
+  queue_t queue_{};
+  absl::flat_hash_map<K, Entry> entries_{};
+  std::size_t capacity_;
+  std::size_t used_{0};
+  weight_t inflation_{0};
+  std::uint64_t tick_{0};
+
+  priority_t priority(const Entry& entry) {
+    return {inflation_ + (CountUses ? weight_t(entry.uses) : weight_t{1}) * entry.weight, tick_++};
+  }
+  void touch(Entry& entry) {
+    ++entry.uses;
+    auto node{queue_.extract(entry.position)};
+    node.key() = priority(entry);
+    entry.position = queue_.insert(std::move(node)).position;
+  }
+  void removeOver(std::size_t limit) {
+    while (used_ > limit) evict();
+  }
+
+public:
+  explicit GreedyDualIndex(std::size_t capacity) : capacity_{capacity} {}
+
+  std::size_t size() const { return entries_.size(); }
+  std::size_t capacity() const { return capacity_; }
+  /**
+   * @return The sum of the sizes of the entries.
+   */
+  std::size_t used() const { return used_; }
+  void recapacitate(std::size_t capacity) {
+    capacity_ = capacity;
+    removeOver(capacity_);
+  }
+
+  /**
+   * Stores the value, replacing the value, weight and size of the same key if it is already stored.
+   * Values larger than the capacity are not stored.
+   */
+  void insert(const K& key, Value value, weight_t weight, std::size_t size = 1) {
+    if (auto it{entries_.find(key)}; it != entries_.end()) {
+      Entry& entry{it->second};
+      used_ -= entry.size;
+      entry.value = std::move(value), entry.weight = weight, entry.size = size;
+      touch(entry);
+      used_ += size;
+      removeOver(capacity_);
+      return;
+    }
+    if (size > capacity_) return;
+    removeOver(capacity_ - size);
+    Entry entry{{}, weight, size, 1, std::move(value)};
+    entry.position = queue_.emplace(priority(entry), key).first;
+    entries_.emplace(key, std::move(entry));
+    used_ += size;
+  }
+  /**
+   * Removes the entry with the lowest priority, which has to exist, and makes its priority the inflation.
+   * @return The key and size of the removed entry.
+   */
+  std::pair<K, std::size_t> evict() {
+    auto it{queue_.begin()};
+    inflation_ = it->first.first;
+    auto entry_it{entries_.find(it->second)};
+    std::pair<K, std::size_t> output{std::move(it->second), entry_it->second.size};
+    used_ -= output.second;
+    entries_.erase(entry_it);
+    queue_.erase(it);
+    return output;
+  }
+  /**
+   * Removes the entry of the key without changing the inflation.
+   * @return The size of the removed entry, if there was one.
+   */
+  std::optional<std::size_t> erase(const K& key) {
+    auto it{entries_.find(key)};
+    if (it == entries_.end()) return std::nullopt;
+    const std::size_t size{it->second.size};
+    used_ -= size;
+    queue_.erase(it->second.position);
+    entries_.erase(it);
+    return size;
+  }
+  /**
+   * @return The entry of the key, which is marked as used, or nullptr if it is not stored.
+   */
+  Value* find(const K& key) {
+    auto it{entries_.find(key)};
+    if (it == entries_.end()) return nullptr;
+    touch(it->second);
+    return &it->second.value;
+  }
+
+  /**
+   * Replaces the contents by the keys of the given index, keeping their priorities.
+   */
+  template<typename OtherValue> void assignKeys(const GreedyDualIndex<K, OtherValue, CountUses>& other) {
+    queue_.clear(), entries_.clear();
+    capacity_ = other.capacity_, used_ = other.used_, inflation_ = other.inflation_, tick_ = other.tick_;
+    for (const auto& [priority, key] : other.queue_) {
+      const auto& other_entry{other.entries_.find(key)->second};
+      entries_.emplace(key, Entry{queue_.emplace_hint(queue_.end(), priority, key), other_entry.weight,
+                                  other_entry.size, other_entry.uses, {}});
+    }
+  }
+
+  /**
+   * Calls the functor with every key, value and size, starting with the next one to be evicted.
+   */
+  template<typename F> void forEach(F functor) const {
+    for (const auto& [priority, key] : queue_) {
+      const Entry& entry{entries_.find(key)->second};
+      functor(key, entry.value, entry.size);
+    }
+  }
+};
+
+/**
+ * The data of a GreedyDualCache, which determines the weights of new entries using a function of their keys and whose
+ * capacity is given in bytes.
+ */
+template<typename K, typename V> class GreedyDualMap {
+public:
+  using index_t = GreedyDualIndex<K, std::shared_ptr<V>>;
+  using weight_t = typename index_t::weight_t;
+  using weight_function_t = std::function<weight_t(const K&)>;
+
+private:
+  index_t index_;
+  weight_function_t weight_function_;
+
+public:
+  GreedyDualMap(std::size_t capacity, weight_function_t weight_function = {})
+      : index_{capacity}, weight_function_{std::move(weight_function)} {}
+
+  std::size_t size() const { return index_.used(); }
+  std::size_t capacity() const { return index_.capacity(); }
+  void recapacitate(std::size_t capacity) { index_.recapacitate(capacity); }
+
+  const index_t& index() const { return index_; }
+  const weight_function_t& weightFunction() const { return weight_function_; }
+  weight_t weight(const K& key) const { return weight_function_ ? weight_function_(key) : weight_t{1}; }
+
+  void insert(const K& key, std::shared_ptr<V> value) { insert(key, std::move(value), weight(key)); }
+  void insert(const K& key, std::shared_ptr<V> value, weight_t weight) {
+    const std::size_t bytes{byteSize(*value)};
+    index_.insert(key, std::move(value), weight, bytes);
+  }
+  std::shared_ptr<V> at(const K& key) {
+    auto value{index_.find(key)};
+    return value ? *value : nullptr;
+  }
+};
+
+/**
+ * The ProtoCache mirroring a GreedyDualCache, which uses the same weights and starts with the same priorities.
+ */
+template<typename E> class GreedyDualProtoCache final : public ProtoCache<E> {
+  struct Empty {};
+  using index_t = GreedyDualIndex<E, Empty>;
+
+public:
+  using element_t = E;
+  using weight_t = typename index_t::weight_t;
+  using weight_function_t = std::function<weight_t(const E&)>;
+
+private:
+  index_t index_;
+  weight_function_t weight_function_;
+
+public:
+  GreedyDualProtoCache(size_t capacity, weight_function_t weight_function = {})
+      : index_{capacity}, weight_function_{std::move(weight_function)} {}
+  template<typename V> GreedyDualProtoCache(const GreedyDualIndex<E, V>& index, weight_function_t weight_function)
+      : GreedyDualProtoCache(index.capacity(), std::move(weight_function)) {
+    index_.assignKeys(index);
+  }
+
+  std::size_t capacity() const final { return index_.capacity(); }
+  std::size_t size() const final { return index_.used(); }
+  void resize(std::size_t capacity) final { index_.recapacitate(capacity); }
+
+  bool contains(const E& element) final { return index_.find(element); }
+
+  void put(E element, std::size_t bytes) final {
+    const weight_t weight{weight_function_ ? weight_function_(element) : weight_t{1}};
+    index_.insert(element, {}, weight, bytes);
+  }
+};
+
+/**
+ * A cache which prefers keeping entries that are expensive to recompute relative to their size, e.g. the tiles of a
+ * large blur over those of a cheap conversion. Without a weight function, it behaves like a least recently used cache.
+ * The weights are determined outside of the lock when putting synchronized.
+ * @tparam K The key type.
+ * @tparam V The value type.
+ */
+template<typename K, typename V> struct GreedyDualCache
+    : public Cache<K, V, GreedyDualMap<K, V>, GreedyDualProtoCache<K>> {
+  using base_t = Cache<K, V, GreedyDualMap<K, V>, GreedyDualProtoCache<K>>;
+  using weight_t = typename GreedyDualMap<K, V>::weight_t;
+  using weight_function_t = typename GreedyDualMap<K, V>::weight_function_t;
+  using base_t::base_t;
+
+  void putSynchronized(const K& key, std::shared_ptr<V> ptr) {
+    const weight_t weight{this->data_.weight(key)};
+    std::lock_guard lock{this->mutex_};
+    this->data_.insert(key, std::move(ptr), weight);
+  }
+  void putSynchronized(const K& key, V&& value) { putSynchronized(key, std::make_shared<V>(std::move(value))); }
+
+  std::unique_ptr<GreedyDualProtoCache<K>> toProtoCache() const {
+    return std::make_unique<GreedyDualProtoCache<K>>(this->data_.index(), this->data_.weightFunction());
+  }
+
+  friend std::ostream& operator<<(std::ostream& stream, const GreedyDualCache& cache) {
+    stream << "[";
+    bool first{true};
+    cache.data_.index().forEach([&](const K& key, const std::shared_ptr<V>& value, std::size_t) {
+      if (not first) stream << ", ";
+      first = false;
+      stream << "(" << key << ": " << *value << ")";
+    });
+    return stream << "]";
+  }
+};
+} // namespace ImageGraph::internal
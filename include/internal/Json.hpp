@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdio>
+#include <ostream>
+#include <string_view>
+
+namespace ImageGraph::internal {
+/**
+ * Writes the string escaped for JSON strings and Prometheus label values, which use the same escapes for quotes,
+ * backslashes and line feeds. Other control characters only occur in JSON, which escapes them as unicode.
+ */
+inline void writeEscaped(std::ostream& stream, std::string_view string) {
+  for (unsigned char c : string) {
+    if (c == '"' or c == '\\')
+      stream << '\\' << c;
+    else if (c == '\n')
+      stream << "\\n";
+    else if (c < 0x20) {
+      char buffer[8];
+      std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      stream << buffer;
+    } else
+      stream << c;
+  }
+}
+} // namespace ImageGraph::internal
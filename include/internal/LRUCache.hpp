@@ -5,6 +5,18 @@
 #include <list>
 #include <memory>
 
+namespace ImageGraph::internal {
+/**
+ * @return The number of bytes occupied by the value, which is size() * sizeof(*data()) for arrays such as tiles.
+ */
+template<typename V> inline std::size_t byteSize(const V& value) {
+  if constexpr (requires { value.size() * sizeof(*value.data()); })
+    return value.size() * sizeof(*value.data());
+  else
+    return sizeof(V);
+}
+} // namespace ImageGraph::internal
+
 namespace {
 template<typename K, typename V> using PairContainer = std::list<std::pair<K, std::shared_ptr<V>>>;
 }
@@ -15,39 +27,47 @@ class LRUMap {
   LookupContainer lookup_{};
   PairContainer<K, V> values_{};
   std::size_t capacity_{};
+  std::size_t bytes_{0};
 
   void remove_over(std::size_t limit) {
-    while (size() > limit) {
+    while (bytes_ > limit) {
+      bytes_ -= ImageGraph::internal::byteSize(*values_.front().second);
       lookup_.erase(values_.front().first);
       values_.pop_front();
     }
   }
 
 public:
+  /**
+   * @param capacity The maximum number of bytes occupied by the values.
+   */
   LRUMap(std::size_t capacity) : capacity_{capacity} {}
+  /**
+   * @return The number of bytes occupied by the values.
+   */
   std::size_t size() const {
     assert(lookup_.size() == values_.size());
-    return values_.size();
+    return bytes_;
   }
+  std::size_t count() const { return values_.size(); }
   std::size_t capacity() const { return capacity_; }
   void recapacitate(std::size_t capacity) {
     if (capacity_ == capacity) return;
     capacity_ = capacity;
     if (not capacity)
-      lookup_.clear(), values_.clear();
+      lookup_.clear(), values_.clear(), bytes_ = 0;
     else
       remove_over(capacity_);
   }
 
   void insert(const K& key, std::shared_ptr<V> value) {
     assert(lookup_.find(key) == lookup_.end());
-    if (capacity_ == 0) {
-      assert(lookup_.empty() and values_.empty());
-      return;
-    }
-    remove_over(capacity_ - 1);
+    const std::size_t bytes{ImageGraph::internal::byteSize(*value)};
+    if (bytes > capacity_) return;
+    remove_over(capacity_ - bytes);
     auto it{values_.emplace(values_.end(), key, std::move(value))};
     lookup_.emplace(std::move(key), it);
+    bytes_ += bytes;
   }
   std::shared_ptr<V> at(const K& key) {
     auto look_it{lookup_.find(key)};
@@ -64,14 +84,21 @@ public:
   auto end() const { return values_.rend(); }
 };
 
-template<typename V, typename LookupContainer = absl::flat_hash_map<V, typename std::list<V>::iterator>> class LRUSet {
+/**
+ * A least recently used set whose elements are given a number of bytes on insertion, which are limited by the capacity.
+ */
+template<typename V, typename LookupContainer =
+                         absl::flat_hash_map<V, typename std::list<std::pair<V, std::size_t>>::iterator>>
+class LRUSet {
   LookupContainer lookup_{};
-  std::list<V> values_{};
+  std::list<std::pair<V, std::size_t>> values_{};
   std::size_t capacity_{};
+  std::size_t bytes_{0};
 
   void remove_over(std::size_t limit) {
-    while (size() > limit) {
-      lookup_.erase(values_.front());
+    while (bytes_ > limit) {
+      bytes_ -= values_.front().second;
+      lookup_.erase(values_.front().first);
       values_.pop_front();
     }
   }
@@ -80,27 +107,26 @@ public:
   LRUSet(std::size_t capacity) : capacity_{capacity} {}
   std::size_t size() const {
     assert(lookup_.size() == values_.size());
-    return values_.size();
+    return bytes_;
   }
+  std::size_t count() const { return values_.size(); }
   std::size_t capacity() const { return capacity_; }
   void recapacitate(std::size_t capacity) {
     if (capacity_ == capacity) return;
     capacity_ = capacity;
     if (not capacity)
-      lookup_.clear(), values_.clear();
+      lookup_.clear(), values_.clear(), bytes_ = 0;
     else
       remove_over(capacity_);
   }
 
-  void insert(V value) {
+  void insert(V value, std::size_t bytes) {
     assert(lookup_.find(value) == lookup_.end());
-    if (capacity_ == 0) {
-      assert(lookup_.empty() and values_.empty());
-      return;
-    }
-    remove_over(capacity_ - 1);
-    auto it{values_.emplace(values_.end(), value)};
+    if (bytes > capacity_) return;
+    remove_over(capacity_ - bytes);
+    auto it{values_.emplace(values_.end(), value, bytes)};
     lookup_.emplace(std::move(value), it);
+    bytes_ += bytes;
   }
   bool exists(const V& value) {
     auto look_it{lookup_.find(value)};
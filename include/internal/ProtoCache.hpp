@@ -2,9 +2,14 @@
 
 #include "Debugging.hpp"
 #include "LRUCache.hpp"
+#include <absl/container/flat_hash_map.h>
 #include <mutex>
+#include <vector>
 
 namespace ImageGraph::internal {
+/**
+ * A cache which only tracks which elements it contains, whose capacity and size are given in bytes.
+ */
 template<typename E> struct ProtoCache {
   using element_t = E;
 
@@ -13,7 +18,10 @@ template<typename E> struct ProtoCache {
   virtual void resize(std::size_t capacity) = 0;
 
   virtual bool contains(const E& element) = 0;
-  virtual void put(E element) = 0;
+  /**
+   * @param bytes The number of bytes the value of the element would occupy.
+   */
+  virtual void put(E element, std::size_t bytes) = 0;
 
   virtual ~ProtoCache() = default;
 };
@@ -34,7 +42,7 @@ public:
 
   bool contains(const E& element) final { return set_.exists(element); }
 
-  void put(E element) final { set_.insert(std::move(element)); }
+  void put(E element, std::size_t bytes) final { set_.insert(std::move(element), bytes); }
 
   friend std::ostream& operator<<(std::ostream& stream, const OrderedMapProtoCache& cache) {
     stream << "[";
@@ -46,4 +54,76 @@ public:
     return stream;
   }
 };
+
+/**
+ * The ProtoCache mirroring a ClockCache, which uses a single CLOCK instead of one per shard.
+ */
+template<typename E> class ClockProtoCache final : public ProtoCache<E> {
+  struct Slot {
+    E element;
+    std::size_t bytes;
+    bool referenced;
+  };
+
+  std::vector<Slot> slots_{};
+  absl::flat_hash_map<E, std::size_t> lookup_{};
+  std::size_t capacity_;
+  std::size_t bytes_{0};
+  std::size_t hand_{0};
+
+  /**
+   * @return The index of the first slot from the hand on whose reference bit is not set, clearing the bits on the way.
+   */
+  std::size_t victim() {
+    for (;; hand_ = (hand_ + 1) % slots_.size()) {
+      Slot& slot{slots_[hand_]};
+      if (not slot.referenced) return hand_;
+      slot.referenced = false;
+    }
+  }
+
+  /**
+   * Removes the slot at the index by moving the last slot into it.
+   */
+  void remove(std::size_t index) {
+    bytes_ -= slots_[index].bytes;
+    lookup_.erase(slots_[index].element);
+    if (index + 1 != slots_.size()) {
+      slots_[index] = std::move(slots_.back());
+      lookup_[slots_[index].element] = index;
+    }
+    slots_.pop_back();
+    if (hand_ >= slots_.size()) hand_ = 0;
+  }
+  void removeOver(std::size_t limit) {
+    while (bytes_ > limit) remove(victim());
+  }
+
+public:
+  using element_t = E;
+
+  explicit ClockProtoCache(size_t capacity) : capacity_{capacity} {}
+
+  std::size_t capacity() const final { return capacity_; }
+  std::size_t size() const final { return bytes_; }
+  void resize(std::size_t capacity) final {
+    capacity_ = capacity;
+    removeOver(capacity_);
+  }
+
+  bool contains(const E& element) final {
+    auto it{lookup_.find(element)};
+    if (it == lookup_.end()) return false;
+    slots_[it->second].referenced = true;
+    return true;
+  }
+
+  void put(E element, std::size_t bytes) final {
+    if (contains(element) or bytes > capacity_) return;
+    removeOver(capacity_ - bytes);
+    lookup_.emplace(element, slots_.size());
+    slots_.push_back({std::move(element), bytes, false});
+    bytes_ += bytes;
+  }
+};
 } // namespace ImageGraph::internal
@@ -1,10 +1,18 @@
 #pragma once
 
 #include "../core/nodes/OutNode.hpp"
+#include "StackDistance.hpp"
 #include "generators/RelevanceChoice.hpp"
 #include <absl/container/flat_hash_map.h>
+#include <functional>
+#include <queue>
 
 namespace ImageGraph::internal {
+/**
+ * Simulates the computation of a graph, summing the durations of the tasks, i.e. the CPU time, while the tasks are
+ * also list scheduled on a number of virtual workers in the order in which they are simulated, each starting once its
+ * inputs are available and a worker is free, which predicts the makespan and the completion times of the sinks.
+ */
 struct ProtoGraphAdaptor {
   using duration_t = std::chrono::duration<double>;
   using durrep_t = duration_t::rep;
@@ -12,15 +20,28 @@ struct ProtoGraphAdaptor {
   using out_tasks_t = std::deque<ProtoOutTask*>;
   using sink_tasks_t = std::deque<ProtoSinkTask*>;
   using relevance_t = SinkNode::relevance_t;
+  using profile_t = StackDistanceProfile<rectangle_t>;
+  using weight_t = profile_t::weight_t;
 
+  /**
+   * Apart from the simulated counts, this contains the stream of requests of the node and the requests it passes on
+   * to its inputs, each of which is weighted by the relevance of the sink causing it, from which a CacheModel is built.
+   */
   struct OutData {
     std::unique_ptr<ProtoCache<rectangle_t>> cache;
     std::size_t computations{0}, requests{0};
     durrep_t duration{};
+    profile_t profile{};
+    weight_t weighted_computations{0}, sink_requests{0};
+    absl::flat_hash_map<const OutNode*, weight_t> input_requests{};
+    // The simulated times at which the cached regions were computed.
+    absl::flat_hash_map<rectangle_t, durrep_t> available{};
     OutData(std::unique_ptr<ProtoCache<rectangle_t>> cache) : cache{std::move(cache)} {}
   };
   struct SinkData {
     durrep_t duration{};
+    // The simulated times at which the last task and the first tiles of the sink are finished.
+    durrep_t completion{}, first_completion{};
     relevance_t relevance;
     SinkData(relevance_t relevance) : relevance{relevance} {}
   };
@@ -30,11 +51,33 @@ struct ProtoGraphAdaptor {
 
 private:
   ProtoSinkTaskSet sink_tasks_{};
+  // The number of tiles requested by each sink task and the time at which they are available.
+  struct SinkProgress {
+    std::size_t requests{0};
+    durrep_t ready{0};
+  };
+  absl::flat_hash_map<const ProtoSinkTask*, SinkProgress> sink_progress_{};
+  std::size_t first_tiles_;
   ProtoTaskRelevanceChoiceGenerator chooser_{};
   out_data_map_t out_data_{};
   sink_data_map_t sink_data_{};
+  // The relevance of the sink whose request is simulated.
+  relevance_t weight_{1};
+  durrep_t weighted_sink_duration_{};
+  // The times at which the virtual workers are free, the earliest first.
+  std::priority_queue<durrep_t, std::vector<durrep_t>, std::greater<>> workers_{};
+  durrep_t makespan_{0};
 
-  durrep_t outRequest(ProtoOutTask& task, OutData& data);
+  void profile(const OutNode& node, OutData& data, rectangle_t region);
+  /**
+   * @return The time at which a task of the given duration whose inputs are available at the given time is finished
+   *         on the earliest free worker.
+   */
+  durrep_t schedule(durrep_t ready, durrep_t duration);
+  /**
+   * @param finish Set to the time at which the task is finished.
+   */
+  durrep_t outRequest(ProtoOutTask& task, OutData& data, durrep_t& finish);
   durrep_t sinkRequest(ProtoSinkTask& task);
   durrep_t sinkPerformable(ProtoSinkTask& task);
 
@@ -46,10 +89,21 @@ public:
     throw std::runtime_error("Invalid request!");
   }
 
-  durrep_t addOutNode(const OutNode& node, std::size_t capacity);
+  /**
+   * @param cache_bytes The maximum number of bytes of the cache of the node.
+   */
+  durrep_t addOutNode(const OutNode& node, std::size_t cache_bytes);
   durrep_t addSinkTask(const SinkNode& node);
 
-  ProtoGraphAdaptor() = default;
+  /**
+   * @param worker_num The number of virtual workers, with one of which the makespan is the sum of the durations.
+   * @param first_tiles The number of tiles of every sink which are requested before any sink requests more and whose
+   *        completion time is tracked.
+   */
+  explicit ProtoGraphAdaptor(std::size_t worker_num = 1, std::size_t first_tiles = 0)
+      : first_tiles_{first_tiles}, chooser_{first_tiles} {
+    for (std::size_t i{0}; i < std::max<std::size_t>(worker_num, 1); ++i) workers_.push(0);
+  }
   ProtoGraphAdaptor(const ProtoGraphAdaptor&) = delete;
   ProtoGraphAdaptor(ProtoGraphAdaptor&&) = default;
 
@@ -59,5 +113,21 @@ public:
   }
   const out_data_map_t& outData() const { return out_data_; }
   const sink_data_map_t& sinkData() const { return sink_data_; }
+  /**
+   * @return The sum of the durations of the sink tasks themselves, weighted by their relevances.
+   */
+  durrep_t weightedSinkDuration() const { return weighted_sink_duration_; }
+  std::size_t workerNum() const { return workers_.size(); }
+  /**
+   * @return The simulated time at which all tasks simulated so far are finished.
+   */
+  durrep_t makespan() const { return makespan_; }
+  /**
+   * Finishes the request profiles once all sink tasks are simulated.
+   */
+  void finishProfiles() {
+    assert(empty());
+    for (auto& [node, data] : out_data_) data.profile.finish();
+  }
 };
 } // namespace ImageGraph::internal
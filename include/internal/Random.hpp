@@ -21,13 +21,18 @@ using distribution_t =
     std::conditional_t<std::is_floating_point_v<T>, std::uniform_real_distribution<T>,
                        std::uniform_int_distribution<T>>;
 
+/**
+ * Types which are not arithmetic, e.g. float16_t, are only meant for storage and are sampled as float.
+ */
+template<typename T> using sample_t = std::conditional_t<std::is_arithmetic_v<T>, T, float>;
+
 template<typename T, typename G,
-         std::enable_if_t<std::is_floating_point_v<T> != std::is_integral_v<T>, bool> = true>
+         std::enable_if_t<std::is_floating_point_v<sample_t<T>> != std::is_integral_v<sample_t<T>>, bool> = true>
 class NumberGenerator {
-  distribution_t<T> distribution_{};
+  distribution_t<sample_t<T>> distribution_{};
   G generator_{};
 
 public:
-  T operator()() { return distribution_(generator_); }
+  T operator()() { return T(distribution_(generator_)); }
 };
 } // namespace ImageGraph::internal
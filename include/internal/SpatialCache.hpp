@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Cache.hpp"
+#include "ProtoCache.hpp"
+#include "TilePool.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * A least recently used map from rectangles to values, which is indexed by a grid of square buckets.
+ * Apart from the stored rectangles themselves, this can find a stored rectangle containing a given one or stored
+ * rectangles covering it together. The capacity limits the sum of the numbers of bytes given for the entries.
+ * @tparam R The rectangle type.
+ * @tparam Value The type of the stored values.
+ */
+template<typename R, typename Value> class SpatialLRUIndex {
+public:
+  /** The edge length of the buckets, which is the default tile edge length. */
+  static constexpr std::size_t bucket_size{32};
+
+private:
+  using entry_t = std::pair<R, Value>;
+  using list_t = std::list<entry_t>;
+  using bucket_t = std::pair<std::size_t, std::size_t>;
+
+public:
+  using iterator_t = typename list_t::iterator;
+
+private:
+  // Ordered from the least to the most recently used entry.
+  list_t values_{};
+  // The entry of each rectangle and its number of bytes.
+  absl::flat_hash_map<R, std::pair<iterator_t, std::size_t>> lookup_{};
+  absl::flat_hash_map<bucket_t, std::vector<iterator_t>> buckets_{};
+  std::size_t capacity_;
+  std::size_t bytes_{0};
+
+  template<typename F> static inline void forBuckets(const R& rectangle, F functor) {
+    if (rectangle.empty()) return;
+    const std::size_t left{rectangle.left() / bucket_size}, top{rectangle.top() / bucket_size},
+        right{(rectangle.left() + rectangle.width() - 1) / bucket_size},
+        bottom{(rectangle.top() + rectangle.height() - 1) / bucket_size};
+    for (std::size_t y{top}; y <= bottom; ++y)
+      for (std::size_t x{left}; x <= right; ++x) functor(bucket_t{x, y});
+  }
+
+  void link(iterator_t it) {
+    forBuckets(it->first, [this, it](bucket_t bucket) { buckets_[bucket].push_back(it); });
+  }
+  void unlink(iterator_t it) {
+    forBuckets(it->first, [this, it](bucket_t bucket) {
+      auto bucket_it{buckets_.find(bucket)};
+      auto& entries{bucket_it->second};
+      entries.erase(std::find(entries.begin(), entries.end(), it));
+      if (entries.empty()) buckets_.erase(bucket_it);
+    });
+  }
+  void removeOver(std::size_t limit) {
+    while (bytes_ > limit) {
+      auto it{values_.begin()};
+      unlink(it);
+      auto look_it{lookup_.find(it->first)};
+      bytes_ -= look_it->second.second;
+      lookup_.erase(look_it);
+      values_.erase(it);
+    }
+  }
+  void touch(iterator_t it) { values_.splice(values_.end(), values_, it); }
+
+  /**
+   * Checks whether the union of the given rectangles contains the given rectangle by dividing it into the cells
+   * formed by all of their edges, each of which is either completely inside or completely outside of every part.
+   */
+  static inline bool covers(const R& rectangle, const std::vector<iterator_t>& parts) {
+    std::vector<std::size_t> xs{rectangle.left(), rectangle.left() + rectangle.width()},
+        ys{rectangle.top(), rectangle.top() + rectangle.height()};
+    const auto add{[](std::vector<std::size_t>& edges, std::size_t begin, std::size_t end, std::size_t edge) {
+      if (begin < edge and edge < end) edges.push_back(edge);
+    }};
+    for (const auto& part : parts) {
+      const R& p{part->first};
+      add(xs, xs[0], xs[1], p.left()), add(xs, xs[0], xs[1], p.left() + p.width());
+      add(ys, ys[0], ys[1], p.top()), add(ys, ys[0], ys[1], p.top() + p.height());
+    }
+    std::sort(xs.begin(), xs.end()), std::sort(ys.begin(), ys.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end()), ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    for (std::size_t j{0}; j + 1 < ys.size(); ++j)
+      for (std::size_t i{0}; i + 1 < xs.size(); ++i) {
+        const R cell{{xs[i], ys[j]}, {xs[i + 1] - xs[i], ys[j + 1] - ys[j]}};
+        const auto contains{[&cell](const auto& part) { return cell.subsetOf(part->first); }};
+        if (std::none_of(parts.begin(), parts.end(), contains)) return false;
+      }
+    return true;
+  }
+
+public:
+  explicit SpatialLRUIndex(std::size_t capacity) : capacity_{capacity} {}
+
+  /**
+   * @return The number of bytes of the entries.
+   */
+  std::size_t size() const { return bytes_; }
+  std::size_t count() const { return values_.size(); }
+  std::size_t capacity() const { return capacity_; }
+  void recapacitate(std::size_t capacity) {
+    capacity_ = capacity;
+    removeOver(capacity_);
+  }
+
+  /**
+   * Stores the value, replacing the value of the same rectangle if it is already stored.
+   * @param bytes The number of bytes occupied by the value.
+   */
+  void insert(const R& key, Value value, std::size_t bytes) {
+    if (auto look_it{lookup_.find(key)}; look_it != lookup_.end()) {
+      auto& [it, old_bytes]{look_it->second};
+      it->second = std::move(value);
+      bytes_ = bytes_ - old_bytes + bytes;
+      old_bytes = bytes;
+      touch(it);
+      removeOver(capacity_);
+      return;
+    }
+    if (bytes > capacity_) return;
+    removeOver(capacity_ - bytes);
+    auto it{values_.emplace(values_.end(), key, std::move(value))};
+    lookup_.emplace(key, std::pair{it, bytes});
+    bytes_ += bytes;
+    link(it);
+  }
+
+  /**
+   * Finds the stored entries from which the given rectangle can be assembled, marking them as used.
+   * @return Either the entry of the rectangle itself, a single entry containing it, several entries covering it or
+   *         no entries if it cannot be assembled.
+   */
+  std::vector<iterator_t> find(const R& rectangle) {
+    if (auto look_it{lookup_.find(rectangle)}; look_it != lookup_.end()) {
+      touch(look_it->second.first);
+      return {look_it->second.first};
+    }
+
+    std::vector<iterator_t> candidates{};
+    forBuckets(rectangle, [this, &rectangle, &candidates](bucket_t bucket) {
+      auto bucket_it{buckets_.find(bucket)};
+      if (bucket_it == buckets_.end()) return;
+      for (iterator_t it : bucket_it->second)
+        if (it->first.overlap(rectangle) and std::find(candidates.begin(), candidates.end(), it) == candidates.end())
+          candidates.push_back(it);
+    });
+
+    auto superset{std::find_if(candidates.begin(), candidates.end(),
+                               [&rectangle](iterator_t it) { return rectangle.subsetOf(it->first); })};
+    if (superset != candidates.end()) {
+      touch(*superset);
+      return {*superset};
+    }
+    if (candidates.empty() or not covers(rectangle, candidates)) return {};
+    for (iterator_t it : candidates) touch(it);
+    return candidates;
+  }
+
+  auto begin() { return values_.rbegin(); }
+  auto begin() const { return values_.rbegin(); }
+  auto end() { return values_.rend(); }
+  auto end() const { return values_.rend(); }
+};
+
+/**
+ * The data of a SpatialCache, which maps rectangles to tiles.
+ */
+template<typename K, typename V> class SpatialLRUMap {
+  using index_t = SpatialLRUIndex<K, std::shared_ptr<V>>;
+
+  index_t index_;
+
+public:
+  explicit SpatialLRUMap(std::size_t capacity) : index_{capacity} {}
+
+  std::size_t size() const { return index_.size(); }
+  std::size_t capacity() const { return index_.capacity(); }
+  void recapacitate(std::size_t capacity) { index_.recapacitate(capacity); }
+  void insert(const K& key, std::shared_ptr<V> value) {
+    const std::size_t bytes{byteSize(*value)};
+    index_.insert(key, std::move(value), bytes);
+  }
+
+  /**
+   * @return The tiles from which the given rectangle can be assembled, which is empty if it cannot.
+   */
+  std::vector<std::shared_ptr<V>> parts(const K& key) {
+    std::vector<std::shared_ptr<V>> output{};
+    for (auto it : index_.find(key)) output.push_back(it->second);
+    return output;
+  }
+  /**
+   * @return The stored tile if it has the given rectangle, otherwise a new tile copied from the parts.
+   */
+  static inline std::shared_ptr<V> assemble(const K& key, const std::vector<std::shared_ptr<V>>& parts) {
+    if (parts.empty()) return nullptr;
+    if (parts.size() == 1 and parts.front()->rectangle() == key) return parts.front();
+    auto output{std::allocate_shared<V>(PoolAllocator<V>{}, key, parts.front()->channels())};
+    for (const auto& part : parts) output->copyOverlap(*part);
+    return output;
+  }
+  std::shared_ptr<V> at(const K& key) { return assemble(key, parts(key)); }
+
+  auto begin() { return index_.begin(); }
+  auto begin() const { return index_.begin(); }
+  auto end() { return index_.end(); }
+  auto end() const { return index_.end(); }
+};
+
+/**
+ * The ProtoCache mirroring a SpatialCache, which contains every rectangle that the latter could assemble.
+ */
+template<typename E> class SpatialProtoCache final : public ProtoCache<E> {
+  struct Empty {};
+
+  SpatialLRUIndex<E, Empty> index_;
+
+public:
+  using element_t = E;
+
+  explicit SpatialProtoCache(size_t capacity) : index_{capacity} {}
+
+  std::size_t capacity() const final { return index_.capacity(); }
+  std::size_t size() const final { return index_.size(); }
+  void resize(std::size_t capacity) final { index_.recapacitate(capacity); }
+
+  bool contains(const E& element) final { return not index_.find(element).empty(); }
+
+  void put(E element, std::size_t bytes) final { index_.insert(element, {}, bytes); }
+};
+
+/**
+ * A cache of tiles, which can also return rectangles that are not stored themselves, but contained in a stored tile
+ * or covered by several of them, e.g. the overlapping input regions of neighbouring tiles of a convolution.
+ * These are copied from the stored tiles outside of the lock.
+ * @tparam K The rectangle type.
+ * @tparam V The tile type.
+ */
+template<typename K, typename V> struct SpatialCache
+    : public Cache<K, V, SpatialLRUMap<K, V>, SpatialProtoCache<K>> {
+  using base_t = Cache<K, V, SpatialLRUMap<K, V>, SpatialProtoCache<K>>;
+  using base_t::base_t;
+
+  std::shared_ptr<V> get(const K& key) { return this->data_.at(key); }
+  std::shared_ptr<V> getSynchronized(const K& key) {
+    std::vector<std::shared_ptr<V>> parts;
+    {
+      std::lock_guard lock{this->mutex_};
+      parts = this->data_.parts(key);
+    }
+    return SpatialLRUMap<K, V>::assemble(key, parts);
+  }
+};
+} // namespace ImageGraph::internal
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Debugging.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ImageGraph::internal {
+/**
+ * Records a stream of accesses to a least recently used cache and yields the number of misses for every capacity
+ * (Mattson's stack distance algorithm): An access hits a cache with a given capacity if the element and all distinct
+ * elements accessed since its last access fit. The numbers of bytes of these are summed using a Fenwick tree over the
+ * times of the last accesses. With elements of different sizes, this is exact up to the bytes freed by evictions.
+ * @tparam E The element type.
+ */
+template<typename E> class StackDistanceProfile {
+public:
+  using weight_t = double;
+
+private:
+  // The Fenwick tree over the numbers of bytes of the elements at the times of their last accesses, starting at 1.
+  std::vector<std::size_t> tree_{0};
+  absl::flat_hash_map<E, std::pair<std::size_t, std::size_t>> last_{};
+  // The stack distance and the weight of each repeated access, sorted by the distance once finished.
+  std::vector<std::pair<std::size_t, weight_t>> distances_{};
+  // The weights of the accesses with at least the stack distance at the same index.
+  std::vector<weight_t> suffix_{};
+  weight_t cold_{0}, accesses_{0};
+  bool finished_{false};
+
+  static constexpr std::size_t lowBit(std::size_t i) { return i & (~i + 1); }
+  std::size_t prefix(std::size_t i) const {
+    std::size_t sum{0};
+    for (; i; i -= lowBit(i)) sum += tree_[i];
+    return sum;
+  }
+  void subtract(std::size_t i, std::size_t bytes) {
+    for (; i < tree_.size(); i += lowBit(i)) tree_[i] -= bytes;
+  }
+  /**
+   * @return The time of the appended access.
+   */
+  std::size_t append(std::size_t bytes) {
+    const std::size_t i{tree_.size()};
+    tree_.push_back(bytes + prefix(i - 1) - prefix(i - lowBit(i)));
+    return i;
+  }
+
+public:
+  /**
+   * Records an access to the element, which is inserted after a miss.
+   * @param bytes The number of bytes the element occupies.
+   * @param weight The weight of the access, e.g. the relevance of the sink requesting it.
+   */
+  void access(const E& element, std::size_t bytes, weight_t weight = 1) {
+    DEBUG_ASSERT(std::logic_error, not finished_, "The profile is already finished!");
+    accesses_ += weight;
+    auto [it, inserted]{last_.try_emplace(element)};
+    auto& [time, old_bytes]{it->second};
+    if (inserted)
+      cold_ += weight;
+    else {
+      distances_.emplace_back(prefix(tree_.size() - 1) - prefix(time) + bytes, weight);
+      subtract(time, old_bytes);
+    }
+    time = append(bytes), old_bytes = bytes;
+  }
+  /**
+   * Records an access which is never cached.
+   */
+  void miss(weight_t weight = 1) {
+    DEBUG_ASSERT(std::logic_error, not finished_, "The profile is already finished!");
+    accesses_ += weight, cold_ += weight;
+  }
+
+  /**
+   * Prepares answering queries, after which no accesses may be recorded.
+   */
+  void finish() {
+    if (finished_) return;
+    finished_ = true;
+    tree_ = {}, last_ = {};
+    std::sort(distances_.begin(), distances_.end());
+    suffix_.resize(distances_.size() + 1);
+    suffix_.back() = 0;
+    for (std::size_t i{distances_.size()}; i-- > 0;) suffix_[i] = suffix_[i + 1] + distances_[i].second;
+  }
+
+  weight_t accesses() const { return accesses_; }
+  /**
+   * @return The weight of the accesses missing a cache with the given number of bytes.
+   */
+  weight_t misses(std::size_t capacity) const {
+    DEBUG_ASSERT(std::logic_error, finished_, "The profile is not finished!");
+    auto it{std::upper_bound(distances_.begin(), distances_.end(), capacity,
+                             [](std::size_t bytes, const auto& distance) { return bytes < distance.first; })};
+    return cold_ + suffix_[std::size_t(it - distances_.begin())];
+  }
+  weight_t missRatio(std::size_t capacity) const { return accesses_ ? misses(capacity) / accesses_ : weight_t{1}; }
+};
+} // namespace ImageGraph::internal
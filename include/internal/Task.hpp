@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../core/Rectangle.hpp"
+#include "../core/Trace.hpp"
 #include "../core/nodes/Node.hpp"
 #include "ThreadPool.hpp"
 #include <boost/container_hash/hash.hpp>
@@ -65,14 +66,22 @@ public:
   /**
    * This function can perform some computations when a required task is finished.
    */
-  void performSingle(const Node& node, rectangle_t rectangle) { performSingleImpl(node, std::move(rectangle)); }
+  void performSingle(const Node& node, rectangle_t rectangle) {
+    if (not Trace::enabled()) return performSingleImpl(node, std::move(rectangle));
+    const auto start{Trace::now()};
+    performSingleImpl(node, rectangle);
+    Trace::complete("performSingle", this->node(), region_, typeid(*this), start, node, rectangle);
+  }
 
   /**
    * This function can perform some computation when all required tasks are finished.
    */
   void performFull() {
     DEBUG_ASSERT(std::runtime_error, allSinglePerformed(), "There are remaining or unfinished tasks!");
+    if (not Trace::enabled()) return performFullImpl();
+    const auto start{Trace::now()};
     performFullImpl();
+    Trace::complete("performFull", node(), region_, typeid(*this), start);
   }
 
   /**
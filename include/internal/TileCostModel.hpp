@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+namespace ImageGraph::internal {
+/**
+ * A linear model of the computation time of a tile, consisting of a fixed overhead, a cost per output pixel and a cost
+ * per halo pixel, i.e. per input pixel beyond the output pixels. It is fitted using least squares with exponential
+ * forgetting, so that it follows changes of the load of the machine, and a prediction is a dot product.
+ */
+class TileCostModel {
+public:
+  static constexpr std::size_t parameter_num{3};
+  using value_t = double;
+  using features_t = std::array<value_t, parameter_num>;
+
+private:
+  // The (forgetting) sums of the products of the features and of the features and the durations.
+  std::array<features_t, parameter_num> gram_{};
+  features_t moments_{};
+  features_t coefficients_{};
+  std::size_t observations_{0};
+
+  /**
+   * Solves the normal equations using Gaussian elimination, where a small ridge makes features which never vary,
+   * e.g. the halo of a per-pixel node, get a coefficient of 0.
+   */
+  void fit() {
+    std::array<std::array<value_t, parameter_num + 1>, parameter_num> system{};
+    for (std::size_t i{0}; i < parameter_num; ++i) {
+      for (std::size_t j{0}; j < parameter_num; ++j) system[i][j] = gram_[i][j];
+      system[i][i] += 1e-9 * gram_[i][i] + 1e-12;
+      system[i][parameter_num] = moments_[i];
+    }
+    for (std::size_t i{0}; i < parameter_num; ++i) {
+      std::size_t pivot{i};
+      for (std::size_t j{i + 1}; j < parameter_num; ++j)
+        if (std::abs(system[j][i]) > std::abs(system[pivot][i])) pivot = j;
+      std::swap(system[i], system[pivot]);
+      for (std::size_t j{i + 1}; j < parameter_num; ++j) {
+        const value_t factor{system[j][i] / system[i][i]};
+        for (std::size_t k{i}; k <= parameter_num; ++k) system[j][k] -= factor * system[i][k];
+      }
+    }
+    for (std::size_t i{parameter_num}; i-- > 0;) {
+      value_t value{system[i][parameter_num]};
+      for (std::size_t j{i + 1}; j < parameter_num; ++j) value -= system[i][j] * coefficients_[j];
+      coefficients_[i] = value / system[i][i];
+    }
+  }
+
+public:
+  static features_t features(std::size_t pixels, std::size_t halo_pixels) {
+    return {1, value_t(pixels), value_t(halo_pixels)};
+  }
+
+  bool empty() const { return not observations_; }
+  std::size_t observations() const { return observations_; }
+  const features_t& coefficients() const { return coefficients_; }
+
+  /**
+   * @param forgetting The portion by which the previous observations are weakened.
+   */
+  void observe(const features_t& features, value_t duration, value_t forgetting = 0) {
+    for (std::size_t i{0}; i < parameter_num; ++i) {
+      for (std::size_t j{0}; j < parameter_num; ++j)
+        gram_[i][j] = (1 - forgetting) * gram_[i][j] + features[i] * features[j];
+      moments_[i] = (1 - forgetting) * moments_[i] + features[i] * duration;
+    }
+    ++observations_;
+    fit();
+  }
+  value_t predict(const features_t& features) const {
+    value_t output{0};
+    for (std::size_t i{0}; i < parameter_num; ++i) output += coefficients_[i] * features[i];
+    return std::max(output, value_t{0});
+  }
+
+  friend std::ostream& operator<<(std::ostream& stream, const TileCostModel& model) {
+    const auto precision{stream.precision(std::numeric_limits<value_t>::max_digits10)};
+    stream << model.observations_;
+    for (const auto& row : model.gram_)
+      for (value_t value : row) stream << " " << value;
+    for (value_t value : model.moments_) stream << " " << value;
+    stream.precision(precision);
+    return stream;
+  }
+  friend std::istream& operator>>(std::istream& stream, TileCostModel& model) {
+    stream >> model.observations_;
+    for (auto& row : model.gram_)
+      for (value_t& value : row) stream >> value;
+    for (value_t& value : model.moments_) stream >> value;
+    if (stream and model.observations_) model.fit();
+    return stream;
+  }
+};
+} // namespace ImageGraph::internal
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace ImageGraph::internal {
+/**
+ * A pool of uninitialized buffers for tile data, which are aligned to 64 bytes and grouped into size classes of powers
+ * of two. Each thread keeps a few free buffers of every class, which are used without locking. Further buffers, as well
+ * as those of exiting threads, are passed to a global pool, which is shared by all threads and whose size is limited.
+ * Requests larger than the largest class bypass the pool.
+ */
+class TilePool {
+public:
+  static constexpr std::size_t alignment{64};
+  /** The number of size classes, the smallest of which holds alignment bytes. */
+  static constexpr std::size_t class_count{26};
+  /** The maximum number of free buffers per size class kept by each thread. */
+  static constexpr std::size_t thread_class_limit{4};
+  /** The maximum number of bytes in free buffers kept by each thread. */
+  static constexpr std::size_t thread_byte_limit{std::size_t(64) << 20};
+
+  /**
+   * @return An uninitialized buffer of at least the given number of bytes, which is aligned to alignment bytes.
+   */
+  static void* allocate(std::size_t bytes);
+  /**
+   * Returns a buffer obtained from allocate to the pool.
+   * @param bytes The number of bytes passed to allocate.
+   */
+  static void deallocate(void* pointer, std::size_t bytes) noexcept;
+
+  /**
+   * Sets the maximum number of bytes in free buffers kept by the global pool, releasing buffers beyond it.
+   */
+  static void setGlobalLimit(std::size_t bytes);
+  static std::size_t globalLimit();
+  /**
+   * @return The number of bytes in free buffers currently kept by the global pool.
+   */
+  static std::size_t globalBytes();
+};
+
+/**
+ * The deleter of arrays which are either allocated by new[] or, if they are trivial, by the TilePool.
+ */
+template<typename T> class ArrayDeleter {
+  std::size_t pooled_size_{0};
+  bool pooled_{false};
+
+public:
+  ArrayDeleter() = default;
+  ArrayDeleter(std::default_delete<T[]>) {}
+  /**
+   * @param size The number of elements allocated from the TilePool.
+   */
+  explicit ArrayDeleter(std::size_t size) : pooled_size_{size}, pooled_{true} {}
+
+  void operator()(T* pointer) const {
+    if (pooled_)
+      TilePool::deallocate(pointer, pooled_size_ * sizeof(T));
+    else
+      delete[] pointer;
+  }
+};
+
+/**
+ * An allocator using the TilePool, e.g. for std::allocate_shared, so that the tile and the control block of a shared
+ * tile are recycled as well.
+ */
+template<typename T> struct PoolAllocator {
+  static_assert(alignof(T) <= TilePool::alignment, "The type requires a stricter alignment than the pool provides!");
+  using value_type = T;
+
+  PoolAllocator() = default;
+  template<typename U> PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t size) { return static_cast<T*>(TilePool::allocate(size * sizeof(T))); }
+  void deallocate(T* pointer, std::size_t size) noexcept { TilePool::deallocate(pointer, size * sizeof(T)); }
+
+  template<typename U> bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+} // namespace ImageGraph::internal
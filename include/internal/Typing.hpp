@@ -89,7 +89,8 @@ public:
   }
 };
 
-using default_numbers_t = TypeList<uint8_t, uint16_t, uint32_t, int8_t, int16_t, int32_t, float32_t, float64_t>;
+using default_numbers_t =
+    TypeList<uint8_t, uint16_t, uint32_t, int8_t, int16_t, int32_t, float16_t, float32_t, float64_t>;
 
 namespace __detail {
 template<typename T, std::size_t I> struct ConstantTupler {
@@ -180,8 +181,10 @@ constexpr static inline Base* dynamic_get_v(const std::tuple<Types*...>& tuple,
 template<typename T> struct pcg_fast_generator {};
 template<> struct pcg_fast_generator<float32_t> : public pcg32_fast {
   pcg_fast_generator() : pcg32_fast(pcg_extras::seed_seq_from<std::random_device>()) {}
+  explicit pcg_fast_generator(std::uint64_t seed) : pcg32_fast(seed) {}
 };
 template<> struct pcg_fast_generator<float64_t> : public pcg64_fast {
   pcg_fast_generator() : pcg64_fast(pcg_extras::seed_seq_from<std::random_device>()) {}
+  explicit pcg_fast_generator(std::uint64_t seed) : pcg64_fast(seed) {}
 };
 } // namespace ImageGraph::internal
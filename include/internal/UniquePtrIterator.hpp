@@ -6,8 +6,8 @@ namespace ImageGraph::internal {
 namespace __detail {
 template<bool Const, typename T> using cond_const_t = std::conditional_t<Const, const T, T>;
 
-template<typename T, bool Const, typename Derived> struct UniquePtrIteratorBase {
-  using data_t = cond_const_t<Const, std::unique_ptr<T[]>>;
+template<typename T, bool Const, typename Deleter, typename Derived> struct UniquePtrIteratorBase {
+  using data_t = cond_const_t<Const, std::unique_ptr<T[], Deleter>>;
 
 protected:
   data_t& data_;
@@ -34,16 +34,16 @@ public:
 };
 } // namespace __detail
 
-template<typename T, bool Const> struct UniquePtrIterator final {};
-template<typename T> struct UniquePtrIterator<T, true> final
-    : public __detail::UniquePtrIteratorBase<T, true, UniquePtrIterator<T, true>> {
-  using base_t = __detail::UniquePtrIteratorBase<T, true, UniquePtrIterator<T, true>>;
+template<typename T, bool Const, typename Deleter = std::default_delete<T[]>> struct UniquePtrIterator final {};
+template<typename T, typename Deleter> struct UniquePtrIterator<T, true, Deleter> final
+    : public __detail::UniquePtrIteratorBase<T, true, Deleter, UniquePtrIterator<T, true, Deleter>> {
+  using base_t = __detail::UniquePtrIteratorBase<T, true, Deleter, UniquePtrIterator<T, true, Deleter>>;
 
   UniquePtrIterator(typename base_t::data_t& data, std::size_t index) : base_t(data, index) {}
 };
-template<typename T> struct UniquePtrIterator<T, false> final
-    : public __detail::UniquePtrIteratorBase<T, false, UniquePtrIterator<T, false>> {
-  using base_t = __detail::UniquePtrIteratorBase<T, false, UniquePtrIterator<T, false>>;
+template<typename T, typename Deleter> struct UniquePtrIterator<T, false, Deleter> final
+    : public __detail::UniquePtrIteratorBase<T, false, Deleter, UniquePtrIterator<T, false, Deleter>> {
+  using base_t = __detail::UniquePtrIteratorBase<T, false, Deleter, UniquePtrIterator<T, false, Deleter>>;
 
   UniquePtrIterator(typename base_t::data_t& data, std::size_t index) : base_t(data, index) {}
   T& operator*() { return this->data_[this->index_]; }
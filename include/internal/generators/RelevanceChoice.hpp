@@ -17,6 +17,7 @@ template<typename T, typename Op> struct RelevanceChoiceGenerator {
   public:
     OutputInfo(T& task, relevance_t relevance) : task_{&task}, relevance{relevance} {}
 
+    std::size_t generationCount() const { return generations; }
     void nextRequiredTask() { task_->nextRequiredTask(); }
     bool allGenerated() const { return task_->allGenerated(); }
     T& task() const { return *task_; }
@@ -34,9 +35,16 @@ template<typename T, typename Op> struct RelevanceChoiceGenerator {
 
 private:
   info_t info_{};
+  // The number of generations of each task which come before all other generations.
+  std::size_t priority_generations_;
 
 public:
-  RelevanceChoiceGenerator() {}
+  /**
+   * @param priority_generations The number of required tasks each task generates before any task generates more, which
+   *        makes the first tiles of all sinks available as early as possible.
+   */
+  explicit RelevanceChoiceGenerator(std::size_t priority_generations = 0)
+      : priority_generations_{priority_generations} {}
 
   void addSinkTask(T& task, relevance_t relevance) {
     if (not task.allGenerated()) info_.emplace_back(task, relevance);
@@ -60,7 +68,11 @@ public:
                   std::any_of(info_.begin(), info_.end(), [](const OutputInfo& info) { return info.allGenerated(); }),
                   "There are tasks that cannot generate more dependencies!");
 
-    auto it{std::min_element(info_.begin(), info_.end())};
+    auto it{std::min_element(info_.begin(), info_.end(), [this](const OutputInfo& a, const OutputInfo& b) {
+      const bool a_priority{a.generationCount() < priority_generations_},
+          b_priority{b.generationCount() < priority_generations_};
+      return a_priority != b_priority ? a_priority : a < b;
+    })};
     DEBUG_ASSERT(std::runtime_error, it != info_.end(), "There is no minimum!");
 
     auto& info{*it};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "NumberTraits.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+
+/*
+ * The element types between which bulk conversions are provided.
+ * The outer and inner lists are separate macros, as a macro cannot be expanded within its own expansion.
+ */
+#define __BULK_CONVERSION_INPUTS(F)                                                                                   \
+  F(std::uint8_t) F(std::uint16_t) F(std::uint32_t) F(std::int8_t) F(std::int16_t) F(std::int32_t) F(float16_t)     \
+      F(float32_t) F(float64_t)
+#define __BULK_CONVERSION_OUTPUTS(F, IN)                                                                              \
+  __BULK_CONVERSION_INTEGRAL_OUTPUTS(F, IN) F(IN, float16_t) F(IN, float32_t) F(IN, float64_t)
+#define __BULK_CONVERSION_INTEGRAL_OUTPUTS(F, IN)                                                                     \
+  F(IN, std::uint8_t) F(IN, std::uint16_t) F(IN, std::uint32_t) F(IN, std::int8_t) F(IN, std::int16_t)              \
+      F(IN, std::int32_t)
+
+namespace ImageGraph::internal {
+/*
+ * convert_normalized for whole arrays, which is compiled for several instruction sets and dispatched at runtime.
+ * input and output may only alias if both have the same type.
+ *
+ * The dithered overloads are only provided for integral outputs and take one noise value in [0, 1) per element,
+ * e.g. from the bulk next of a dither stream, which has the same role as random_norm in convert_normalized.
+ */
+#define __BULK_CONVERSION_DECLARE(IN, OUT) void convert_normalized_bulk(const IN* input, OUT* output, std::size_t size);
+#define __BULK_CONVERSION_DECLARE_DITHERED(IN, OUT)                                                                   \
+  void convert_normalized_bulk(const IN* input, OUT* output, std::size_t size,                                       \
+                               const least_floating_point_t<OUT>* noise);
+#define __BULK_CONVERSION_DECLARE_INPUT(IN)                                                                           \
+  __BULK_CONVERSION_OUTPUTS(__BULK_CONVERSION_DECLARE, IN)                                                           \
+  __BULK_CONVERSION_INTEGRAL_OUTPUTS(__BULK_CONVERSION_DECLARE_DITHERED, IN)
+__BULK_CONVERSION_INPUTS(__BULK_CONVERSION_DECLARE_INPUT)
+#undef __BULK_CONVERSION_DECLARE_INPUT
+#undef __BULK_CONVERSION_DECLARE_DITHERED
+#undef __BULK_CONVERSION_DECLARE
+
+template<typename OutputType, typename InputType> struct is_bulk_convertible {
+  static inline constexpr bool value{requires(const InputType* input, OutputType* output) {
+    convert_normalized_bulk(input, output, std::size_t{});
+  }};
+};
+template<typename OutputType, typename InputType> static inline constexpr bool is_bulk_convertible_v =
+    is_bulk_convertible<OutputType, InputType>::value;
+
+/**
+ * Converts chunks of the inputs to FloatType, calls kernel(count, values, others...) on them, which has to write its
+ * results into values, the chunk of the first input, and converts these to the output, all without dithering.
+ * This way, the kernel is a plain loop over floating point values, which the compiler can vectorize.
+ */
+template<typename FloatType, typename OutputType, typename Kernel, typename... InputTypes>
+requires(is_bulk_convertible_v<FloatType, InputTypes> and...) and is_bulk_convertible_v<OutputType, FloatType>
+static inline void transform_normalized_bulk(OutputType* output, std::size_t size, Kernel&& kernel,
+                                             const InputTypes*... inputs) {
+  constexpr std::size_t chunk_size{1024};
+  std::array<std::array<FloatType, chunk_size>, sizeof...(InputTypes)> buffers;
+  for (std::size_t i{0}; i < size; i += chunk_size) {
+    const std::size_t count{std::min(chunk_size, size - i)};
+    [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+      (convert_normalized_bulk(inputs + i, buffers[Indices].data(), count), ...);
+      kernel(count, buffers[Indices].data()...);
+    }(std::index_sequence_for<InputTypes...>{});
+    convert_normalized_bulk(buffers[0].data(), output + i, count);
+  }
+}
+} // namespace ImageGraph::internal
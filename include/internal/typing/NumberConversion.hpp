@@ -1,6 +1,6 @@
 #pragma once
 
-#include "../Random.hpp"
+#include "../Dither.hpp"
 #include "NumberTraits.hpp"
 #include <optional>
 
@@ -9,7 +9,7 @@ namespace ImageGraph::internal {
 // saturate_cast
 
 template<typename OutType, typename InType> inline static constexpr OutType saturate_cast(InType input) {
-  constexpr OutType min{std::numeric_limits<OutType>::min()}, max{std::numeric_limits<OutType>::max()};
+  constexpr OutType min{std::numeric_limits<OutType>::lowest()}, max{std::numeric_limits<OutType>::max()};
   return input >= max ? max : (input <= min ? min : OutType(input));
 }
 
@@ -28,7 +28,9 @@ convert_normalized_dithered(InputType input, Generator& gen) {
   else if constexpr (is_floating_point_v<OutputType> and is_floating_point_v<InputType>)
     return saturate_cast<OutputType>(input);
   else if constexpr (is_floating_point_v<OutputType>) {
-    constexpr OutputType p5{.5}, factor{white_point_v<OutputType> / OutputType(white_point_v<InputType>)};
+    // The computation is performed in least_t, as OutputType might only be meant for storage.
+    using least_t = least_floating_point_t<OutputType>;
+    constexpr least_t p5{.5}, factor{least_t(white_point_v<OutputType>) / least_t(white_point_v<InputType>)};
     // Here, one needs to choose an interval which one quantized integer value x represents:
     // Is it [x, x + 1), [x - 0.5, x + 0.5), or even [x - 1, x)?
     // Only the first two option really make any sense, and for a long time I tended to prefer the former,
@@ -37,7 +39,7 @@ convert_normalized_dithered(InputType input, Generator& gen) {
     // performing two conversions in a row. As I now think that preserving the perceived brightness
     // of an image than trying to revert a cast that has possibly, but not certainly happened,
     // the second option is now implemented.
-    return factor * (input + random_real<OutputType>(gen, -p5, p5));
+    return OutputType(factor * (input + random_real<least_t>(gen, -p5, p5)));
   } else {
     using least_t = least_common_floating_point_t<OutputType, InputType>;
     constexpr least_t factor{least_t(white_point_v<OutputType>) / least_t(white_point_v<InputType>)};
@@ -53,8 +55,9 @@ convert_normalized_undithered(InputType input) {
   else if constexpr (is_floating_point_v<OutputType> and is_floating_point_v<InputType>)
     return saturate_cast<OutputType>(input);
   else if constexpr (is_floating_point_v<OutputType>) {
-    constexpr OutputType factor{white_point_v<OutputType> / OutputType(white_point_v<InputType>)};
-    return factor * input;
+    using least_t = least_floating_point_t<OutputType>;
+    constexpr least_t factor{least_t(white_point_v<OutputType>) / least_t(white_point_v<InputType>)};
+    return OutputType(factor * input);
   } else {
     using least_t = least_common_floating_point_t<OutputType, InputType>;
     constexpr least_t p5{.5}, factor{least_t(white_point_v<OutputType>) / least_t(white_point_v<InputType>)};
@@ -10,6 +10,7 @@ namespace ImageGraph::internal {
 // is_floating_point and is_integral.
 
 template<typename T> struct is_floating_point { static inline constexpr bool value{std::is_floating_point_v<T>}; };
+template<> struct is_floating_point<float16_t> { static inline constexpr bool value{true}; };
 template<typename T> static inline constexpr bool is_floating_point_v = is_floating_point<T>::value;
 
 template<typename T> struct is_integral { static inline constexpr bool value{std::is_integral_v<T>}; };
@@ -18,6 +19,7 @@ template<typename T> static inline constexpr bool is_integral_v = is_integral<T>
 // is_signed
 
 template<typename T> struct is_signed : public std::is_signed<T> {};
+template<> struct is_signed<float16_t> : public std::true_type {};
 template<class T> inline constexpr bool is_signed_v = is_signed<T>::value;
 
 // unsign
@@ -39,6 +41,7 @@ template<> struct least_floating_point<uint32_t> { using type = float64_t; };
 template<> struct least_floating_point<int8_t> { using type = float32_t; };
 template<> struct least_floating_point<int16_t> { using type = float32_t; };
 template<> struct least_floating_point<int32_t> { using type = float64_t; };
+template<> struct least_floating_point<float16_t> { using type = float32_t; };
 template<> struct least_floating_point<float32_t> { using type = float32_t; };
 template<> struct least_floating_point<float64_t> { using type = float64_t; };
 template<typename T> using least_floating_point_t = typename least_floating_point<T>::type;
@@ -55,6 +58,7 @@ template<> struct white_point<uint32_t> { constexpr static uint32_t value{std::n
 template<> struct white_point<int8_t> { constexpr static int8_t value{std::numeric_limits<int8_t>::max()}; };
 template<> struct white_point<int16_t> { constexpr static int16_t value{std::numeric_limits<int16_t>::max()}; };
 template<> struct white_point<int32_t> { constexpr static int32_t value{std::numeric_limits<int32_t>::max()}; };
+template<> struct white_point<float16_t> { constexpr static float16_t value{1.f}; };
 template<> struct white_point<float32_t> { constexpr static float32_t value{1.f}; };
 template<> struct white_point<float64_t> { constexpr static float64_t value{1.}; };
 template<typename T> inline constexpr T white_point_v = white_point<T>::value;
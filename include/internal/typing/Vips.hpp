@@ -5,6 +5,9 @@
 #include <vips/vips8>
 
 namespace ImageGraph::internal {
+/**
+ * VIPS has no half precision format, so float16_t can only be used by nodes which are neither loaded nor written.
+ */
 template<typename T> struct band_format {};
 template<> struct band_format<uint8_t> { constexpr static VipsBandFormat value{VipsBandFormat::VIPS_FORMAT_UCHAR}; };
 template<> struct band_format<uint16_t> { constexpr static VipsBandFormat value{VipsBandFormat::VIPS_FORMAT_USHORT}; };
@@ -15,6 +18,7 @@ template<> struct band_format<int32_t> { constexpr static VipsBandFormat value{V
 template<> struct band_format<float32_t> { constexpr static VipsBandFormat value{VipsBandFormat::VIPS_FORMAT_FLOAT}; };
 template<> struct band_format<float64_t> { constexpr static VipsBandFormat value{VipsBandFormat::VIPS_FORMAT_DOUBLE}; };
 template<typename T> inline constexpr VipsBandFormat band_format_v = band_format<T>::value;
+template<typename T> inline constexpr bool has_band_format_v = requires { band_format<T>::value; };
 } // namespace ImageGraph::internal
 
 static inline std::ostream& operator<<(std::ostream& stream, VipsBandFormat format) {
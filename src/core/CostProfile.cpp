@@ -0,0 +1,34 @@
+#include "../../include/core/CostProfile.hpp"
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace ImageGraph;
+
+// The first line of a profile file, which changes with the format.
+constexpr std::string_view profile_header{"ImageGraphCostProfile 1"};
+
+bool CostProfile::save(const std::filesystem::path& path) const {
+  std::ofstream stream{path};
+  std::lock_guard lock{mutex_};
+  stream << profile_header << "\n" << models_.size() << "\n";
+  for (const auto& [kind, model] : models_) stream << kind << " " << model << "\n";
+  return bool(stream);
+}
+
+bool CostProfile::load(const std::filesystem::path& path) {
+  std::ifstream stream{path};
+  std::string header{};
+  if (not std::getline(stream, header) or header != profile_header) return false;
+
+  std::size_t count{};
+  stream >> count;
+  std::vector<std::pair<kind_t, model_t>> models(count);
+  for (auto& [kind, model] : models) stream >> kind >> model;
+  if (not stream) return false;
+
+  std::lock_guard lock{mutex_};
+  for (auto& [kind, model] : models) models_.insert_or_assign(kind, std::move(model));
+  return true;
+}
@@ -0,0 +1,163 @@
+#include "../../include/core/ExecutionPlan.hpp"
+#include "../../include/core/NodeGraph.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string_view>
+
+using namespace ImageGraph;
+
+using signature_t = GraphSignature::signature_t;
+
+/**
+ * The 64 bit FNV-1a hash, which unlike std::hash is the same in every process.
+ */
+struct Fnv1a {
+  signature_t hash{0xcbf29ce484222325};
+
+  void add(std::string_view data) {
+    for (unsigned char c : data) hash = (hash ^ c) * 0x100000001b3;
+  }
+  void add(std::uint64_t value) {
+    for (std::size_t i{0}; i < 8; ++i) hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 0x100000001b3;
+  }
+};
+
+std::string GraphSignature::structuralName(const Node& node) {
+  std::ostringstream stream{};
+  stream << node;
+  const std::string description{stream.str()};
+  const auto is_hex{[&description](std::size_t i) {
+    return i < description.size() and std::isxdigit((unsigned char)description[i]);
+  }};
+  constexpr std::string_view path{"path=\""};
+  std::string output{};
+  for (std::size_t i{0}; i < description.size();) {
+    if (description.compare(i, 2, "0x") == 0 and is_hex(i + 2)) {
+      for (i += 2; is_hex(i);) ++i;
+      output.push_back('?');
+    } else if (description.compare(i, path.size(), path) == 0) {
+      // The paths are escaped, so the first quote which is not escaped ends them.
+      for (i += path.size(); i < description.size() and description[i] != '"';) i += description[i] == '\\' ? 2 : 1;
+      ++i;
+      output.append("path=?");
+    } else
+      output.push_back(description[i++]);
+  }
+  return output;
+}
+
+signature_t GraphSignature::kind(const Node& node) {
+  Fnv1a hash{};
+  hash.add(typeid(node).name());
+  hash.add(structuralName(node));
+  hash.add(node.channels());
+  return hash.hash;
+}
+
+signature_t GraphSignature::visit(const Node& node) {
+  if (auto it{nodes_.find(&node)}; it != nodes_.end()) return it->second;
+
+  Fnv1a hash{};
+  hash.add(kind(node));
+  hash.add(node.width()), hash.add(node.height());
+  hash.add(std::uint64_t(node.memoryMode())), hash.add(node.inputCount());
+  for (std::size_t i{0}; i < node.inputCount(); ++i) hash.add(visit(node.inputNode(i)));
+  if (auto sink{dynamic_cast<const SinkNode*>(&node)}) hash.add(std::bit_cast<std::uint64_t>(sink->relevance()));
+  nodes_.emplace(&node, hash.hash);
+
+  if (auto out{dynamic_cast<const OutNode*>(&node)}) {
+    outputs_.try_emplace(out, hash.hash);
+    if (out->hasParents() and out->topParent().is_output) {
+      Fnv1a output_hash{hash};
+      output_hash.add(std::uint64_t{1});
+      outputs_.try_emplace(&out->outputNode(), output_hash.hash);
+    }
+  }
+  return hash.hash;
+}
+
+void GraphSignature::number(const OutNode& node, absl::flat_hash_map<signature_t, std::size_t>& counts) {
+  if (indices_.contains(&node)) return;
+  for (std::size_t i{0}; i < node.inputCount(); ++i) number(node.inputNode(i), counts);
+  indices_.try_emplace(&node, counts[outputs_.at(&node)]++);
+  if (node.hasParents() and node.topParent().is_output) {
+    const OutNode& output{node.outputNode()};
+    indices_.try_emplace(&output, counts[outputs_.at(&output)]++);
+  }
+}
+
+GraphSignature::GraphSignature(const NodeGraph& graph) {
+  std::vector<std::pair<signature_t, const SinkNode*>> sinks{};
+  for (const auto& sink : graph.sinkNodes()) sinks.emplace_back(visit(*sink), sink.get());
+  // Sinks with the same hash cannot be told apart, so their order does not matter.
+  std::sort(sinks.begin(), sinks.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+  Fnv1a hash{};
+  for (const auto& sink : sinks) hash.add(sink.first);
+  signature_ = hash.hash;
+
+  absl::flat_hash_map<signature_t, std::size_t> counts{};
+  for (const auto& [sink_signature, sink] : sinks)
+    for (std::size_t i{0}; i < sink->inputCount(); ++i) number(sink->inputNode(i), counts);
+}
+
+std::filesystem::path ExecutionPlan::fileName(signature_t signature, std::size_t memory_limit) {
+  std::ostringstream name{};
+  name << std::hex << std::setw(16) << std::setfill('0') << signature << std::dec << "-" << memory_limit << ".plan";
+  return name.str();
+}
+
+// The first line of a plan file, which changes with the format.
+constexpr std::string_view plan_header{"ImageGraphPlan 3"};
+
+bool ExecutionPlan::save(const std::filesystem::path& path) const {
+  // The plan is written to a temporary file which replaces the file at once, so that concurrent readers or a crash
+  // never see a partial plan.
+  std::filesystem::path temporary{path};
+  temporary += "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    std::ofstream stream{temporary};
+    stream << plan_header << "\n" << signature << " " << memory_limit << "\n";
+    stream << cache_bytes.size() << "\n";
+    for (const auto& [node, bytes] : cache_bytes) stream << node.first << " " << node.second << " " << bytes << "\n";
+    stream << cost_models.size() << "\n";
+    for (const auto& [node, model] : cost_models) stream << node << " " << model << "\n";
+    if (not stream.flush()) {
+      std::error_code error{};
+      std::filesystem::remove(temporary, error);
+      return false;
+    }
+  }
+  std::error_code error{};
+  std::filesystem::rename(temporary, path, error);
+  if (not error) return true;
+  std::filesystem::remove(temporary, error);
+  return false;
+}
+
+std::optional<ExecutionPlan> ExecutionPlan::load(const std::filesystem::path& path) {
+  std::ifstream stream{path};
+  std::string header{};
+  if (not std::getline(stream, header) or header != plan_header) return std::nullopt;
+
+  ExecutionPlan plan{};
+  std::size_t count{};
+  stream >> plan.signature >> plan.memory_limit >> count;
+  for (std::size_t i{0}; stream and i < count; ++i) {
+    std::pair<node_key_t, std::size_t> entry{};
+    stream >> entry.first.first >> entry.first.second >> entry.second;
+    plan.cache_bytes.push_back(entry);
+  }
+  stream >> count;
+  for (std::size_t i{0}; stream and i < count; ++i) {
+    std::pair<signature_t, internal::TileCostModel> entry{};
+    stream >> entry.first >> entry.second;
+    plan.cost_models.push_back(std::move(entry));
+  }
+  if (not stream) return std::nullopt;
+  return plan;
+}
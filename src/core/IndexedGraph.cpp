@@ -0,0 +1,58 @@
+#include "../../include/core/IndexedGraph.hpp"
+
+using namespace ImageGraph;
+
+void IndexedGraph::add(Node& root) {
+  if (indices_.contains(&root)) return;
+  // The nodes whose inputs are being numbered and the index of their next input.
+  std::vector<std::pair<Node*, std::size_t>> stack{{&root, 0}};
+  while (not stack.empty()) {
+    auto& [node, next]{stack.back()};
+    if (next < node->inputCount()) {
+      Node& input{node->inputNode(next++)};
+      if (not indices_.contains(&input)) stack.emplace_back(&input, 0);
+      continue;
+    }
+    indices_.emplace(node, nodes_.size());
+    nodes_.push_back(node);
+    out_nodes_.push_back(dynamic_cast<OutNode*>(node));
+    stack.pop_back();
+  }
+}
+
+void IndexedGraph::connect() {
+  inputs_.resize(nodes_.size());
+  successors_.resize(nodes_.size());
+  for (index_t i{0}; i < nodes_.size(); ++i) {
+    const Node& node{*nodes_[i]};
+    inputs_[i].reserve(node.inputCount());
+    for (std::size_t j{0}; j < node.inputCount(); ++j) {
+      const index_t input{indices_.at(&node.inputNode(j))};
+      assert(input < i);
+      inputs_[i].push_back(input);
+      successors_[input].push_back(i);
+    }
+  }
+}
+
+IndexedGraph::IndexedGraph(const NodeGraph::sink_nodes_t& sink_nodes, const NodeGraph::out_nodes_t& out_nodes) {
+  for (const auto& sink : sink_nodes) add(*sink);
+  for (const auto& out : out_nodes) add(*out);
+  connect();
+}
+
+IndexedGraph::IndexedGraph(const NodeGraph::sink_nodes_t& sink_nodes) {
+  for (const auto& sink : sink_nodes) add(*sink);
+  connect();
+}
+
+std::vector<IndexedGraph::bitset_t> IndexedGraph::transitiveInputs() const {
+  std::vector<bitset_t> output(nodes_.size(), bitset_t(nodes_.size()));
+  for (index_t i{0}; i < nodes_.size(); ++i) {
+    for (index_t input : inputs_[i]) {
+      output[i].set(input);
+      output[i] |= output[input];
+    }
+  }
+  return output;
+}
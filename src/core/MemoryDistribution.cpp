@@ -1,53 +1,22 @@
 #include "../../include/core/MemoryDistribution.hpp"
-#include <absl/container/flat_hash_map.h>
-#include <absl/container/flat_hash_set.h>
+#include "../../include/core/IndexedGraph.hpp"
+#include "../../include/core/Metrics.hpp"
 #include <boost/random/beta_distribution.hpp>
 
 using namespace ImageGraph;
 using namespace ImageGraph::internal;
 
 ProtoGraphAdaptor MemoryDistribution::generateAdaptor(const sinks_t& sink_nodes, info_t cache_nodes,
-                                                      out_part_t non_cache_nodes) {
-  ProtoGraphAdaptor adaptor{};
+                                                      out_part_t non_cache_nodes, std::size_t worker_num,
+                                                      std::size_t first_tiles) {
+  ProtoGraphAdaptor adaptor{worker_num, first_tiles};
   for (auto& sink : sink_nodes) adaptor.addSinkTask(*sink);
-  for (auto& out : cache_nodes) adaptor.addOutNode(out.node, out.node.cacheSizeFromBytes(out.byte_num));
+  for (auto& out : cache_nodes) adaptor.addOutNode(out.node, out.byte_num);
   for (auto& out : non_cache_nodes) adaptor.addOutNode(*out, 0);
   return std::move(adaptor);
 }
 
 using prob_t = MemoryDistribution::prob_t;
-struct Probs {
-  prob_t own_prob, cum_prob;
-  Probs(prob_t own_prob, prob_t cum_prob) : own_prob{own_prob}, cum_prob{cum_prob} {}
-};
-using prob_map_t = absl::flat_hash_map<const OutNode*, Probs>;
-using inputs_t = absl::flat_hash_set<const OutNode*>;
-
-void inputs(const OutNode& node, inputs_t& input_set) {
-  const std::size_t input_count{node.inputCount()};
-  for (std::size_t i{0}; i < input_count; ++i) {
-    auto& input{node.inputNode(i)};
-    if (input_set.insert(&input).second) inputs(input, input_set);
-  }
-}
-
-Probs computeProbs(const OutNode& node, prob_map_t& probabilities) {
-  auto it{probabilities.find(&node)};
-  if (it != probabilities.end()) return it->second;
-
-  const std::size_t input_count{node.inputCount()};
-  const prob_t base{node.changeProbability()};
-  assert(0 <= base and base <= 1);
-  prob_t prob{1. - base};
-
-  inputs_t input_set{};
-  inputs(node, input_set);
-  for (const auto* input : input_set) prob *= 1. - computeProbs(*input, probabilities).own_prob;
-
-  Probs probs{base, 1. - prob};
-  probabilities.emplace(&node, probs);
-  return probs;
-}
 
 MemoryDistribution::argument_tuple_t
 MemoryDistribution::generate_members(std::size_t memory_limit, const outs_t& out_nodes, const sinks_t& sink_nodes) {
@@ -56,10 +25,29 @@ MemoryDistribution::generate_members(std::size_t memory_limit, const outs_t& out
   std::size_t important_bytes{0}, unimportant_bytes{0};
   bool enough_bytes{true};
 
-  prob_map_t probabilities{};
+  // The structure is traversed in topological order and the removal probabilities use the transitive inputs as bitsets,
+  // which keeps planning large graphs fast.
+  const IndexedGraph graph{sink_nodes, out_nodes};
+  const auto transitive_inputs{graph.transitiveInputs()};
+  std::vector<prob_t> own_probs(graph.size(), 0);
+  for (std::size_t i{0}; i < graph.size(); ++i) {
+    if (const OutNode* node{graph.outNode(i)}) own_probs[i] = node->changeProbability();
+    assert(0 <= own_probs[i] and own_probs[i] <= 1);
+  }
+  // The probability that the node or one of its transitive inputs changes.
+  const auto cum_prob{[&own_probs, &transitive_inputs](std::size_t index) {
+    prob_t prob{1. - own_probs[index]};
+    const auto& inputs{transitive_inputs[index]};
+    for (auto i{inputs.find_first()}; i != IndexedGraph::bitset_t::npos; i = inputs.find_next(i))
+      prob *= 1. - own_probs[i];
+    return 1. - prob;
+  }};
 
-  for (const auto& ptr : out_nodes) {
-    const OutNode& node{*ptr};
+  for (std::size_t i{0}; i < graph.size(); ++i) {
+    const OutNode* out{graph.outNode(i)};
+    // Sinks are not cached and nodes replaced by an optimized node are never computed.
+    if (not out or out->hasParents()) continue;
+    const OutNode& node{*out};
     switch (node.memoryMode()) {
       case MemoryMode::NO_MEMORY: {
         non_cache_nodes.push_back(&node);
@@ -67,8 +55,7 @@ MemoryDistribution::generate_members(std::size_t memory_limit, const outs_t& out
       }
       case MemoryMode::ANY_MEMORY: {
         const std::size_t bytes{node.fullByteNumber()};
-        Probs probs{computeProbs(node, probabilities)};
-        cache_nodes.emplace_back(node, 0, bytes, probs.own_prob, probs.cum_prob);
+        cache_nodes.emplace_back(node, 0, bytes, own_probs[i], cum_prob(i));
         if (node.isCacheImportant())
           important_bytes += bytes;
         else
@@ -125,40 +112,147 @@ MemoryDistribution::generate_members(std::size_t memory_limit, const outs_t& out
           MemoryAmount(amount)};
 }
 
+MemoryDistribution::prob_t MemoryDistribution::wasted(const info_t& cache_nodes) {
+  // Compute the memory loss (based on the removal probabilities)
+  prob_t wasted{0}, full{0};
+  for (const auto& info : cache_nodes) {
+    const prob_t prob{info.cum_removal_prob};
+    assert(0 <= prob and prob <= 1);
+    const std::size_t cache_size{info.byte_num};
+    full += cache_size;
+    wasted += prob * cache_size;
+  }
+  // Without any cache bytes, nothing can be wasted.
+  return full ? wasted / full : 0;
+}
+
+MemoryDistribution::cost_t MemoryDistribution::modelCost(const CacheModel& model, const info_t& cache_nodes,
+                                                          std::vector<CacheModel::Usage>& usages) {
+  std::vector<std::size_t> capacities(model.size(), 0);
+  for (const auto& info : cache_nodes)
+    if (auto index{model.index(info.node)}) capacities[*index] = info.byte_num;
+  return (1. + wasted(cache_nodes)) * model.cost(capacities, usages);
+}
+
 MemoryDistribution::cost_t MemoryDistribution::cost() const {
+  if (model_) return modelCost(*model_, cache_nodes_, usages_);
+
   // Perform the time computations
   cost_t raw_cost{0};
   while (not adaptor_.empty()) raw_cost += adaptor_.frontRequestableNextRequiredTask();
   assert(raw_cost >= 0);
 
-  // Compute the time cost
+  // Compute the time cost, which is the latency of the (first tiles of the) sinks if they are computed in parallel
+  const auto sink_cost{[this](const ProtoGraphAdaptor::SinkData& datum) {
+    if (first_tiles_) return datum.first_completion;
+    return worker_num_ > 1 ? datum.completion : datum.duration;
+  }};
   double cost{0}, cumulative{0};
   const auto& sink_data{adaptor_.sinkData()};
   for (const auto& datum : sink_data) {
     assert(datum.second.relevance >= 0);
     cumulative += datum.second.relevance;
-    cost += datum.second.relevance * datum.second.duration;
+    cost += datum.second.relevance * sink_cost(datum.second);
   }
-
-  // Compute the memory loss (based on the removal probabilities)
-  prob_t wasted{0}, full{0};
-  for (const auto& info : cache_nodes_) {
-    const prob_t prob{info.cum_removal_prob};
-    assert(0 <= prob and prob <= 1);
-    const std::size_t cache_size{info.byte_num};
-    full += cache_size;
-    wasted += prob * cache_size;
-  }
-  wasted /= full;
+  const prob_t wasted{MemoryDistribution::wasted(cache_nodes_)};
 
   if (cumulative == 0) return 0;
   cost *= cost_t(sink_data.size()) / cumulative;
-  std::cout << "raw cost vs. actual cost: " << raw_cost << " / " << cost << " with " << wasted << " wasted"
-            << std::endl;
+  if (Metrics::enabled())
+    Metrics::global().counter("imagegraph_simulations_total", "The simulated computations of distributions.").add();
+  if (Metrics::verbose())
+    std::cout << "raw cost vs. actual cost: " << raw_cost << " / " << cost << " with " << wasted
+              << " wasted, makespan " << adaptor_.makespan() << " on " << worker_num_ << " workers" << std::endl;
   assert(0 <= wasted and wasted <= 1);
   return (1. + wasted) * cost;
 }
 
+std::shared_ptr<const CacheModel> MemoryDistribution::buildModel() const {
+  assert(not model_ and adaptor_.empty());
+  adaptor_.finishProfiles();
+  return std::make_shared<const CacheModel>(adaptor_);
+}
+
+std::shared_ptr<const CacheModel> MemoryDistribution::buildModel(const std::vector<Feedback>& feedback) const {
+  assert(not model_ and adaptor_.empty());
+  adaptor_.finishProfiles();
+  auto model{std::make_shared<CacheModel>(adaptor_)};
+  for (const auto& entry : feedback) {
+    const prob_t predicted{entry.predictedMissRatio()};
+    model->calibrate(entry.node, predicted ? entry.measuredMissRatio() / predicted : 1, entry.measuredDuration());
+  }
+  return model;
+}
+
+std::vector<MemoryDistribution::Feedback> MemoryDistribution::feedback() const {
+  assert(not model_);
+  while (not adaptor_.empty()) adaptor_.frontRequestableNextRequiredTask();
+  std::vector<Feedback> output{};
+  output.reserve(cache_nodes_.size());
+  for (const auto& info : cache_nodes_) {
+    const auto& datum{adaptor_.outData().at(&info.node)};
+    const cost_t duration{datum.computations ? datum.duration / cost_t(datum.computations) : 0};
+    output.push_back({info.node, datum.requests, datum.computations, info.node.cacheStatistics(), duration});
+  }
+  return output;
+}
+
+MemoryDistribution MemoryDistribution::derive(info_t cache_nodes, std::shared_ptr<const CacheModel> model) const {
+  MemoryDistribution output(std::move(model), worker_num_, first_tiles_, memory_limit_, sink_nodes_,
+                            std::move(cache_nodes), non_cache_nodes_, memory_amount_);
+  output.seed(generator_());
+  return output;
+}
+
+MemoryDistribution MemoryDistribution::greedy(std::shared_ptr<const CacheModel> model) const {
+  // The number of chunks the free bytes are divided into.
+  constexpr std::size_t chunk_num{32};
+
+  info_t cache_nodes{cache_nodes_};
+  std::size_t free_bytes{memory_limit_};
+  for (auto& info : cache_nodes) {
+    if (not info.node.isCacheImportant()) info.byte_num = 0;
+    free_bytes -= info.byte_num;
+  }
+  const std::size_t chunk{std::max<std::size_t>(free_bytes / chunk_num, 1)};
+
+  std::vector<CacheModel::Usage> usages{};
+  const auto evaluate{[&](const info_t& nodes) {
+    return model ? modelCost(*model, nodes, usages) : derive(nodes, nullptr).cost();
+  }};
+  cost_t current{evaluate(cache_nodes)};
+  while (free_bytes) {
+    std::size_t best_node{cache_nodes.size()}, best_bytes{0};
+    cost_t best_cost{current}, best_saving{0};
+    for (std::size_t i{0}; i < cache_nodes.size(); ++i) {
+      auto& info{cache_nodes[i]};
+      const std::size_t old_bytes{info.byte_num}, room{std::min(info.max_byte_num - old_bytes, free_bytes)};
+      for (std::size_t bytes{std::min(chunk, room)}; bytes; bytes = bytes == room ? 0 : std::min(2 * bytes, room)) {
+        info.byte_num = old_bytes + bytes;
+        const cost_t cost{evaluate(cache_nodes)};
+        const cost_t saving{(current - cost) / cost_t(bytes)};
+        if (saving > best_saving) best_node = i, best_bytes = bytes, best_cost = cost, best_saving = saving;
+      }
+      info.byte_num = old_bytes;
+    }
+    if (best_node == cache_nodes.size()) break;
+    cache_nodes[best_node].byte_num += best_bytes;
+    free_bytes -= best_bytes, current = best_cost;
+  }
+  return derive(std::move(cache_nodes), std::move(model));
+}
+
+std::pair<prob_t, prob_t> MemoryDistribution::usage(const OutNode& node) const {
+  if (model_) {
+    auto index{model_->index(node)};
+    if (not index) return {0, 0};
+    const auto& usage{usages_.at(*index)};
+    return {usage.requests, usage.computations};
+  }
+  const auto& datum{adaptor_.outData().at(&node)};
+  return {prob_t(datum.requests), prob_t(datum.computations)};
+}
+
 MemoryDistribution MemoryDistribution::random_neighbour() const {
   struct NodeProbability {
     const prob_t probability;
@@ -167,9 +261,8 @@ MemoryDistribution MemoryDistribution::random_neighbour() const {
   };
 
   constexpr prob_t _0{0}, _1{1};
-  assert(adaptor_.empty());
+  assert(adaptor_.empty() and (not model_ or not usages_.empty()));
   const prob_t eps{1e-2}, one_eps{_1 - eps};
-  const auto& out_data{adaptor_.outData()};
   const std::size_t node_num{cache_nodes_.size()};
 
   prob_t cumulative{0};
@@ -178,11 +271,11 @@ MemoryDistribution MemoryDistribution::random_neighbour() const {
   for (std::size_t i{0}; i < node_num; ++i) {
     const auto& info{cache_nodes_.at(i)};
     assert(info.byte_num <= info.max_byte_num);
-    const auto& out_datum{out_data.at(&info.node)};
-    assert(out_datum.computations <= out_datum.requests);
-    if (not out_datum.requests) continue;
+    const auto [requests, computations]{usage(info.node)};
+    assert(computations <= requests);
+    if (not requests) continue;
     const prob_t memory_portion{prob_t(info.byte_num) / prob_t(info.max_byte_num)},
-        non_hit_portion{prob_t(out_datum.computations) / prob_t(out_datum.requests)};
+        non_hit_portion{computations / requests};
     const prob_t prob{memory_portion * (eps + one_eps * non_hit_portion)};
     if (prob) {
       cumulative += prob;
@@ -200,11 +293,11 @@ MemoryDistribution MemoryDistribution::random_neighbour() const {
     if (i == from.index) continue;
     const auto& info{cache_nodes_.at(i)};
     assert(info.byte_num <= info.max_byte_num);
-    const auto& out_datum{out_data.at(&info.node)};
-    assert(out_datum.computations <= out_datum.requests);
-    if (not out_datum.requests) continue;
+    const auto [requests, computations]{usage(info.node)};
+    assert(computations <= requests);
+    if (not requests) continue;
     const prob_t memory_portion{prob_t(info.max_byte_num - info.byte_num) / prob_t(info.max_byte_num)},
-        hit_portion{prob_t(out_datum.requests - out_datum.computations) / prob_t(out_datum.requests)};
+        hit_portion{(requests - computations) / requests};
     const prob_t prob{memory_portion * (eps + one_eps * hit_portion)};
     if (prob) {
       cumulative += prob;
@@ -222,5 +315,5 @@ MemoryDistribution MemoryDistribution::random_neighbour() const {
   assert(max_bytes >= 1);
   auto moved_bytes{size_t(std::ceil(boost::random::beta_distribution(2., 4.)(generator_) * max_bytes))};
   from_info.byte_num -= moved_bytes, to_info.byte_num += moved_bytes;
-  return MemoryDistribution(memory_limit_, sink_nodes_, std::move(new_cache_nodes), non_cache_nodes_, memory_amount_);
+  return derive(std::move(new_cache_nodes), model_);
 }
@@ -0,0 +1,165 @@
+#include "../../include/core/Metrics.hpp"
+#include "../../include/core/ExecutionPlan.hpp"
+#include "../../include/internal/Json.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+using namespace ImageGraph;
+using internal::writeEscaped;
+
+using value_t = Metrics::value_t;
+
+void Metrics::Histogram::observe(value_t value) {
+  const auto index{std::size_t(std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin())};
+  ++counts_[index];
+  sum_ += value;
+}
+
+Metrics::Metric& Metrics::get(const std::string& name, Type type, const std::string& help, const labels_t& labels,
+                              const bounds_t& bounds) {
+  std::lock_guard lock{mutex_};
+  auto [it, inserted]{families_.try_emplace(name, Family{type, help, bounds})};
+  Family& family{it->second};
+  if (family.type != type) throw std::invalid_argument("The metric " + name + " has a different type!");
+  auto& metric{family.metrics[labels]};
+  if (not metric) {
+    switch (type) {
+      case Type::COUNTER: metric = std::make_unique<Counter>(); break;
+      case Type::GAUGE: metric = std::make_unique<Gauge>(); break;
+      case Type::HISTOGRAM: metric = std::make_unique<Histogram>(family.bounds); break;
+    }
+  }
+  return *metric;
+}
+
+Metrics::bounds_t Metrics::exponentialBounds(value_t first, value_t factor, std::size_t count) {
+  bounds_t output{};
+  output.reserve(count);
+  for (value_t bound{first}; output.size() < count; bound *= factor) output.push_back(bound);
+  return output;
+}
+
+std::string Metrics::nodeLabel(const Node& node) { return GraphSignature::structuralName(node); }
+std::string Metrics::nodeLabel(const Node& node, std::size_t index) {
+  return GraphSignature::structuralName(node) + " #" + std::to_string(index);
+}
+
+constexpr const char* typeName(Metrics::Type type) {
+  switch (type) {
+    case Metrics::Type::COUNTER: return "counter";
+    case Metrics::Type::GAUGE: return "gauge";
+    case Metrics::Type::HISTOGRAM: return "histogram";
+  }
+  return "untyped";
+}
+
+void Metrics::writeJson(std::ostream& stream) const {
+  std::lock_guard lock{mutex_};
+  const auto precision{stream.precision(std::numeric_limits<value_t>::digits10)};
+  stream << "{";
+  bool first_family{true};
+  for (const auto& [name, family] : families_) {
+    stream << (first_family ? "\n  \"" : ",\n  \"");
+    writeEscaped(stream, name);
+    stream << "\": {\"type\": \"" << typeName(family.type) << "\", \"help\": \"";
+    writeEscaped(stream, family.help);
+    stream << "\", \"metrics\": [";
+    bool first_metric{true};
+    for (const auto& [labels, metric] : family.metrics) {
+      stream << (first_metric ? "\n    {\"labels\": {" : ",\n    {\"labels\": {");
+      for (std::size_t i{0}; i < labels.size(); ++i) {
+        stream << (i ? ", \"" : "\"");
+        writeEscaped(stream, labels[i].first);
+        stream << "\": \"";
+        writeEscaped(stream, labels[i].second);
+        stream << "\"";
+      }
+      stream << "}, ";
+      switch (family.type) {
+        case Type::COUNTER: stream << "\"value\": " << static_cast<const Counter&>(*metric).value(); break;
+        case Type::GAUGE: stream << "\"value\": " << static_cast<const Gauge&>(*metric).value(); break;
+        case Type::HISTOGRAM: {
+          const auto& histogram{static_cast<const Histogram&>(*metric)};
+          std::size_t count{0};
+          stream << "\"buckets\": [";
+          for (std::size_t i{0}; i < histogram.bounds().size(); ++i) {
+            count += histogram.bucket(i);
+            stream << (i ? ", [" : "[") << histogram.bounds()[i] << ", " << count << "]";
+          }
+          count += histogram.bucket(histogram.bounds().size());
+          stream << "], \"count\": " << count << ", \"sum\": " << histogram.sum();
+          break;
+        }
+      }
+      stream << "}";
+      first_metric = false;
+    }
+    stream << (first_metric ? "]}" : "\n  ]}");
+    first_family = false;
+  }
+  stream << (first_family ? "}\n" : "\n}\n");
+  stream.precision(precision);
+}
+
+/**
+ * Writes the labels in braces, followed by the given extra label if there is one, e.g. the bucket bound.
+ */
+void writeLabels(std::ostream& stream, const Metrics::labels_t& labels, const std::string& extra_name = {},
+                 const std::string& extra_value = {}) {
+  if (labels.empty() and extra_name.empty()) return;
+  stream << "{";
+  for (std::size_t i{0}; i < labels.size(); ++i) {
+    stream << (i ? "," : "") << labels[i].first << "=\"";
+    writeEscaped(stream, labels[i].second);
+    stream << "\"";
+  }
+  if (not extra_name.empty()) stream << (labels.empty() ? "" : ",") << extra_name << "=\"" << extra_value << "\"";
+  stream << "}";
+}
+
+void Metrics::writePrometheus(std::ostream& stream) const {
+  std::lock_guard lock{mutex_};
+  const auto precision{stream.precision(std::numeric_limits<value_t>::digits10)};
+  for (const auto& [name, family] : families_) {
+    stream << "# HELP " << name << " " << family.help << "\n# TYPE " << name << " " << typeName(family.type) << "\n";
+    for (const auto& [labels, metric] : family.metrics) {
+      switch (family.type) {
+        case Type::COUNTER:
+          stream << name;
+          writeLabels(stream, labels);
+          stream << " " << static_cast<const Counter&>(*metric).value() << "\n";
+          break;
+        case Type::GAUGE:
+          stream << name;
+          writeLabels(stream, labels);
+          stream << " " << static_cast<const Gauge&>(*metric).value() << "\n";
+          break;
+        case Type::HISTOGRAM: {
+          const auto& histogram{static_cast<const Histogram&>(*metric)};
+          std::size_t count{0};
+          for (std::size_t i{0}; i <= histogram.bounds().size(); ++i) {
+            count += histogram.bucket(i);
+            std::ostringstream bound{};
+            bound.precision(std::numeric_limits<value_t>::digits10);
+            if (i < histogram.bounds().size())
+              bound << histogram.bounds()[i];
+            else
+              bound << "+Inf";
+            stream << name << "_bucket";
+            writeLabels(stream, labels, "le", bound.str());
+            stream << " " << count << "\n";
+          }
+          stream << name << "_sum";
+          writeLabels(stream, labels);
+          stream << " " << histogram.sum() << "\n" << name << "_count";
+          writeLabels(stream, labels);
+          stream << " " << count << "\n";
+          break;
+        }
+      }
+    }
+  }
+  stream.precision(precision);
+}
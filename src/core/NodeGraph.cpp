@@ -1,15 +1,59 @@
 #include "core/NodeGraph.hpp"
+#include "core/CostProfile.hpp"
 #include "core/MemoryDistribution.hpp"
+#include "core/Metrics.hpp"
 #include "core/SizedArray.hpp"
+#include "core/Trace.hpp"
 #include "internal/Annealer.hpp"
 #include "internal/GraphAdaptor.hpp"
 #include "internal/ProtoGraphAdaptor.hpp"
 #include "internal/ThreadPool.hpp"
 #include "internal/generators/RelevanceChoice.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
 
 using namespace ImageGraph;
 using namespace internal;
 
+// The maximum number of times the cache model is rebuilt from the simulation of the annealed distribution.
+constexpr std::size_t model_rounds{4};
+
+/**
+ * Adds the cache statistics of the last computation to the global metrics.
+ */
+void recordCacheStatistics(const NodeGraph::out_nodes_t& out_nodes) {
+  Metrics& metrics{Metrics::global()};
+  for (const auto& node : out_nodes) {
+    const auto statistics{node->cacheStatistics()};
+    if (not statistics.requests) continue;
+    const Metrics::labels_t labels{{"node", node->metricsLabel()}};
+    metrics.counter("imagegraph_cache_requests_total", "The requests of tiles of a node.", labels)
+        .add(statistics.requests);
+    metrics.counter("imagegraph_cache_hits_total", "The requests of tiles found in the cache of a node.", labels)
+        .add(statistics.hits);
+    metrics.counter("imagegraph_tile_computations_total", "The tiles of a node which had to be computed.", labels)
+        .add(statistics.computations);
+  }
+}
+
+/**
+ * Labels the computed nodes by their structural names and their indices among the nodes with the same name, which are
+ * numbered in the order of their hashes and their indices in the signature, so that the labels are the same in every
+ * run of the same graph.
+ */
+void labelNodes(const NodeGraph& graph) {
+  const GraphSignature signature{graph};
+  std::vector<std::tuple<GraphSignature::signature_t, std::size_t, const OutNode*>> nodes{};
+  for (const auto& [node, hash] : signature.outputs()) nodes.emplace_back(hash, signature.index(*node), node);
+  std::sort(nodes.begin(), nodes.end());
+  absl::flat_hash_map<std::string, std::size_t> counts{};
+  for (const auto& [hash, index, node] : nodes) {
+    const std::string name{GraphSignature::structuralName(*node)};
+    node->setMetricsLabel(Metrics::nodeLabel(*node, counts[name]++));
+  }
+}
+
 NodeGraph::~NodeGraph() {
   finish();
   for (auto& node : out_nodes_)
@@ -22,50 +66,106 @@ NodeGraph::~NodeGraph() {
         ++it;
 }
 
-MemoryDistribution NodeGraph::optimizeMemoryDistribution(std::size_t memory_limit) const {
-  MemoryDistribution distribution{memory_limit, out_nodes_, sink_nodes_};
+MemoryDistribution NodeGraph::optimizeMemoryDistribution(std::size_t memory_limit, Planner planner,
+                                                          std::optional<size_t> opt_thread_num,
+                                                          std::optional<std::uint64_t> opt_seed,
+                                                          std::size_t worker_num, std::size_t first_tiles) const {
+  MemoryDistribution distribution{memory_limit, out_nodes_, sink_nodes_, worker_num, first_tiles};
+  if (opt_seed) distribution.seed(*opt_seed);
   switch (distribution.memoryAmount()) {
     case MemoryDistribution::MemoryAmount::ENOUGH_FOR_ALL: {
-      std::cout << "There is enough memory for everyone!" << std::endl;
+      if (Metrics::verbose()) std::cout << "There is enough memory for everyone!" << std::endl;
       break;
     }
     case MemoryDistribution::MemoryAmount::SUFFICIENT: {
-      if (not distribution.memoryLimit())
-        std::cout << "The memory precisely suffices for the necessary parts!" << std::endl;
-      else {
+      if (not distribution.memoryLimit()) {
+        if (Metrics::verbose()) std::cout << "The memory precisely suffices for the necessary parts!" << std::endl;
+      } else {
         if (distribution.cacheNodes().size() <= 1) {
-          std::cout << "Fewer than 2 nodes, nothing to distribute!" << std::endl;
+          if (Metrics::verbose()) std::cout << "Fewer than 2 nodes, nothing to distribute!" << std::endl;
           return distribution;
         }
-        auto result{Annealer<MemoryDistribution>().perform(std::move(distribution), 4, 0.5, 0.95, 0)};
-        std::cout << "result:" << std::endl;
-        std::cout << "out nodes:" << std::endl;
-        for (const auto& info : result.solution.outData())
-          std::cout << *info.first << ": " << info.second.computations << " / " << info.second.requests
-                    << " with cache size "
-                    << (info.second.cache ? info.second.cache->size() : 0) * info.first->elementBytes() << " of "
-                    << info.first->fullByteNumber() << " at " << info.second.duration << "s" << std::endl;
-        std::cout << "sink nodes:" << std::endl;
-        for (const auto& info : result.solution.sinkData())
-          std::cout << *info.first << ": " << info.second.relevance << " at " << info.second.duration << "s"
-                    << std::endl;
-        std::cout << "cache nodes:" << std::endl;
-        for (const auto& info : result.solution.cacheNodes())
-          std::cout << info.node << ": " << info.byte_num << " / " << info.max_byte_num << " with probabilities "
-                    << info.own_removal_prob << " / " << info.cum_removal_prob << std::endl;
-        std::cout << "result cost: " << result.cost << std::endl;
-        return std::move(result.solution);
+        auto annealer{opt_seed ? Annealer<MemoryDistribution>(*opt_seed) : Annealer<MemoryDistribution>()};
+        annealer.setVerbose(false);
+        const std::size_t thread_num{opt_thread_num ? *opt_thread_num : 0};
+        // Plan using the model of the best simulated distribution until its simulation no longer improves.
+        std::optional<MemoryDistribution> best{std::move(distribution)};
+        MemoryDistribution::cost_t best_cost{best->cost()};
+        for (std::size_t round{0}; round < model_rounds; ++round) {
+          // Objectives which the model cannot estimate are planned by simulating every candidate.
+          auto model{best->modelsCost() ? best->buildModel() : nullptr};
+          MemoryDistribution planned{
+              planner == Planner::GREEDY
+                  ? best->greedy(std::move(model))
+                  : annealer.perform(best->modelled(std::move(model)), 256, 0.5, 0.99, thread_num).solution};
+          auto simulated{planned.simulated()};
+          const MemoryDistribution::cost_t cost{simulated.cost()};
+          if (Metrics::enabled())
+            Metrics::global()
+                .counter("imagegraph_planning_rounds_total", "The rounds of rebuilding the cache model.")
+                .add();
+          if (Metrics::verbose())
+            std::cout << "round " << round << ": modelled cost " << planned.cost() << ", simulated cost " << cost
+                      << std::endl;
+          // A cost which is not finite is never better, although a NaN does not compare as larger.
+          if (not std::isfinite(cost) or cost >= best_cost) break;
+          best.emplace(std::move(simulated)), best_cost = cost;
+        }
+        if (Metrics::enabled())
+          Metrics::global().gauge("imagegraph_planned_cost", "The simulated cost of the last planned distribution.")
+              .set(best_cost);
+        if (Metrics::verbose()) {
+          std::cout << "result:" << std::endl;
+          std::cout << "out nodes:" << std::endl;
+          for (const auto& info : best->outData())
+            std::cout << *info.first << ": " << info.second.computations << " / " << info.second.requests
+                      << " with cache size "
+                      << (info.second.cache ? info.second.cache->size() : 0) << " of "
+                      << info.first->fullByteNumber() << " at " << info.second.duration << "s" << std::endl;
+          std::cout << "sink nodes:" << std::endl;
+          for (const auto& info : best->sinkData())
+            std::cout << *info.first << ": " << info.second.relevance << " at " << info.second.duration << "s"
+                      << std::endl;
+          std::cout << "cache nodes:" << std::endl;
+          for (const auto& info : best->cacheNodes())
+            std::cout << info.node << ": " << info.byte_num << " / " << info.max_byte_num << " with probabilities "
+                      << info.own_removal_prob << " / " << info.cum_removal_prob << std::endl;
+          std::cout << "result cost: " << best_cost << std::endl;
+        }
+        return std::move(*best);
       }
       break;
     }
     case MemoryDistribution::MemoryAmount::TOO_LITTLE: {
-      std::cout << "There is too little memory for even the necessary parts!" << std::endl;
+      if (Metrics::verbose()) std::cout << "There is too little memory for even the necessary parts!" << std::endl;
       break;
     }
   }
   return std::move(distribution);
 }
 
+MemoryDistribution NodeGraph::replanMemoryDistribution(const MemoryDistribution& distribution, Planner planner,
+                                                        std::optional<size_t> opt_thread_num,
+                                                        std::optional<std::uint64_t> opt_seed) const {
+  const auto feedback{distribution.feedback()};
+  if (Metrics::verbose()) {
+    std::cout << "feedback:" << std::endl;
+    for (const auto& entry : feedback) std::cout << entry << std::endl;
+  }
+
+  if (distribution.memoryAmount() != MemoryDistribution::MemoryAmount::SUFFICIENT or
+      distribution.cacheNodes().size() <= 1)
+    return distribution.simulated();
+  // The result is simulated again, so that it can in turn be compared with the next computation. Without a model, the
+  // feedback is only printed, as the candidates are simulated.
+  auto model{distribution.modelsCost() ? distribution.buildModel(feedback) : nullptr};
+  if (planner == Planner::GREEDY) return distribution.greedy(std::move(model)).simulated();
+  auto annealer{opt_seed ? Annealer<MemoryDistribution>(*opt_seed) : Annealer<MemoryDistribution>()};
+  annealer.setVerbose(false);
+  const std::size_t thread_num{opt_thread_num ? *opt_thread_num : 0};
+  return annealer.perform(distribution.modelled(std::move(model)), 256, 0.5, 0.99, thread_num).solution.simulated();
+}
+
 bool NodeGraph::handleFinished(GraphAdaptor& adaptor, pool_deque_t finished, pool_t& pool) {
   if (finished.empty()) return false;
   while (not finished.empty()) {
@@ -105,7 +205,12 @@ void NodeGraph::finish() {
   }
 }
 
-void NodeGraph::compute(MemoryDistribution distribution, std::optional<size_t> opt_thread_num) {
+void NodeGraph::compute(const MemoryDistribution& distribution, std::optional<size_t> opt_thread_num) {
+  for (const auto& info : distribution.cacheNodes()) info.node.setCacheBytes(info.byte_num);
+  computeTasks(std::move(opt_thread_num), distribution.firstTiles());
+}
+
+void NodeGraph::computeTasks(std::optional<size_t> opt_thread_num, std::size_t first_tiles) {
   struct RunManager {
     RunState& run;
     std::mutex& mutex;
@@ -130,13 +235,21 @@ void NodeGraph::compute(MemoryDistribution distribution, std::optional<size_t> o
     }
   };
 
-  const size_t thread_num{opt_thread_num ? *opt_thread_num : std::thread::hardware_concurrency()};
+  const size_t thread_num{threadNum(opt_thread_num)};
   RunManager finish{run_, mutex_, compute_finished_};
-  GraphAdaptor adaptor{};
+  GraphAdaptor adaptor{first_tiles};
   pool_t pool{thread_num};
 
+  for (auto& node : out_nodes_) node->resetCacheStatistics();
+  if (Metrics::enabled()) labelNodes(*this);
+  if (Trace::enabled()) Trace::nameThread("coordinator");
   for (auto& sink : sink_nodes_) adaptor.addSinkTask(*sink);
-  for (const auto& info : distribution.cacheNodes()) info.node.setCacheBytes(info.byte_num);
+  // The number of tasks which can be performed whenever they are handed to the pool.
+  Metrics::Histogram* queue_depth{
+      Metrics::enabled() ? &Metrics::global().histogram("imagegraph_performable_tasks",
+                                                        "The number of performable tasks handed to the pool at once.",
+                                                        {}, Metrics::exponentialBounds(1, 2, 16))
+                         : nullptr};
 
   while (not adaptor.empty() and finish.check()) {
     while (adaptor.emptyPerformable() and finish.check()) {
@@ -148,6 +261,7 @@ void NodeGraph::compute(MemoryDistribution distribution, std::optional<size_t> o
       }
       break;
     }
+    if (queue_depth and not adaptor.emptyPerformable()) queue_depth->observe(double(adaptor.performableCount()));
     while (not adaptor.emptyPerformable() and finish.check()) {
       Task& task{*adaptor.extractPerformable()};
       pool.execute({task, false}, [&task] { task.performFull(); });
@@ -158,19 +272,73 @@ void NodeGraph::compute(MemoryDistribution distribution, std::optional<size_t> o
       handleFinished(adaptor, pool.getFinished(), pool);
     }
   }
+  for (const auto& node : out_nodes_) node->storeCostModel();
+  if (Metrics::enabled()) recordCacheStatistics(out_nodes_);
 }
-void NodeGraph::compute(std::size_t memory_limit, std::optional<size_t> opt_thread_num) {
-  compute(optimizeMemoryDistribution(memory_limit), std::move(opt_thread_num));
+void NodeGraph::compute(std::size_t memory_limit, std::optional<size_t> opt_thread_num, Planner planner,
+                        std::size_t first_tiles) {
+  compute(optimizeMemoryDistribution(memory_limit, planner, opt_thread_num, std::nullopt, 1, first_tiles),
+          std::move(opt_thread_num));
+}
+
+ExecutionPlan NodeGraph::plan(std::size_t memory_limit, const MemoryDistribution& distribution) const {
+  const GraphSignature signature{*this};
+  const auto& outputs{signature.outputs()};
+  ExecutionPlan plan{signature.signature(), memory_limit};
+  for (const auto& info : distribution.cacheNodes()) {
+    auto it{outputs.find(&info.node)};
+    if (it != outputs.end())
+      plan.cache_bytes.emplace_back(ExecutionPlan::node_key_t{it->second, signature.index(info.node)}, info.byte_num);
+  }
+  for (const auto& [node, node_signature] : outputs)
+    if (auto model{node->costModel()}) plan.cost_models.emplace_back(node_signature, std::move(*model));
+  return plan;
+}
+
+void NodeGraph::compute(const ExecutionPlan& plan, std::optional<size_t> opt_thread_num) {
+  const GraphSignature signature{*this};
+  if (signature.signature() != plan.signature) throw std::invalid_argument("The plan belongs to a different graph!");
+
+  const absl::flat_hash_map<ExecutionPlan::node_key_t, std::size_t> cache_bytes(plan.cache_bytes.begin(),
+                                                                                plan.cache_bytes.end());
+  absl::flat_hash_map<GraphSignature::signature_t, internal::TileCostModel> models{};
+  for (const auto& [node, model] : plan.cost_models) models.insert_or_assign(node, model);
+
+  for (const auto& [node, node_signature] : signature.outputs()) {
+    if (auto it{models.find(node_signature)}; it != models.end()) node->loadCostModel(it->second);
+    if (auto it{cache_bytes.find({node_signature, signature.index(*node)})}; it != cache_bytes.end())
+      node->setCacheBytes(it->second);
+  }
+  computeTasks(std::move(opt_thread_num));
+}
+
+void NodeGraph::compute(std::size_t memory_limit, const std::filesystem::path& plan_directory,
+                        std::optional<size_t> opt_thread_num, Planner planner) {
+  const auto path{plan_directory / ExecutionPlan::fileName(GraphSignature{*this}.signature(), memory_limit)};
+  if (auto plan{ExecutionPlan::load(path)}; plan and plan->memory_limit == memory_limit) {
+    compute(*plan, std::move(opt_thread_num));
+    return;
+  }
+  // The kinds of nodes calibrated in earlier runs need not be calibrated again when planning.
+  const auto profile_path{plan_directory / "costs.profile"};
+  CostProfile::global().load(profile_path);
+  auto distribution{optimizeMemoryDistribution(memory_limit, planner, opt_thread_num)};
+  for (const auto& info : distribution.cacheNodes()) info.node.setCacheBytes(info.byte_num);
+  computeTasks(std::move(opt_thread_num));
+  std::filesystem::create_directories(plan_directory);
+  if (not plan(memory_limit, distribution).save(path))
+    std::cerr << "The plan could not be saved to " << path << "!" << std::endl;
+  if (not CostProfile::global().save(profile_path))
+    std::cerr << "The cost profile could not be saved to " << profile_path << "!" << std::endl;
 }
 
 using duration_t = NodeGraph::duration_t;
 
-duration_t NodeGraph::computationDuration(std::size_t size) {
-  ProtoGraphAdaptor adaptor{};
-  duration_t::rep time{0};
-  for (auto& sink : sink_nodes_) time += adaptor.addSinkTask(*sink);
-  for (auto& out : out_nodes_) time += adaptor.addOutNode(*out, size);
+duration_t NodeGraph::computationDuration(std::size_t cache_bytes, std::size_t worker_num) {
+  ProtoGraphAdaptor adaptor{worker_num};
+  for (auto& sink : sink_nodes_) adaptor.addSinkTask(*sink);
+  for (auto& out : out_nodes_) adaptor.addOutNode(*out, cache_bytes);
 
-  while (not adaptor.empty()) time += adaptor.frontRequestableNextRequiredTask();
-  return duration_t{time};
+  while (not adaptor.empty()) adaptor.frontRequestableNextRequiredTask();
+  return duration_t{adaptor.makespan()};
 }
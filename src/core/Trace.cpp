@@ -0,0 +1,184 @@
+#include "../../include/core/Trace.hpp"
+#include "../../include/internal/Json.hpp"
+#include <absl/container/flat_hash_map.h>
+#include <algorithm>
+#include <boost/core/demangle.hpp>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+using namespace ImageGraph;
+using internal::writeEscaped;
+
+using Event = Trace::Event;
+
+namespace {
+/**
+ * The ring buffer of a thread, which is only written by that thread.
+ */
+class Buffer {
+  std::unique_ptr<Event[]> events_;
+  const std::size_t capacity_;
+  // The number of events recorded, of which the last capacity_ are kept.
+  std::atomic<std::size_t> next_{0};
+
+public:
+  const std::size_t id;
+  // The name shown in the trace, which is guarded by the mutex of the registry.
+  std::string name{};
+
+  Buffer(std::size_t id, std::size_t capacity)
+      : events_{std::make_unique<Event[]>(capacity)}, capacity_{capacity}, id{id} {}
+
+  void push(const Event& event) {
+    const std::size_t next{next_.load(std::memory_order_relaxed)};
+    events_[next % capacity_] = event;
+    next_.store(next + 1, std::memory_order_release);
+  }
+  void clear() { next_.store(0, std::memory_order_relaxed); }
+
+  template<typename Function> void forEach(Function function) const {
+    const std::size_t end{next_.load(std::memory_order_acquire)};
+    for (std::size_t i{end > capacity_ ? end - capacity_ : 0}; i < end; ++i) function(events_[i % capacity_]);
+  }
+};
+
+std::string defaultName(std::size_t id) { return "thread " + std::to_string(id); }
+
+struct Registry {
+  std::mutex mutex{};
+  std::vector<std::unique_ptr<Buffer>> buffers{};
+  // The buffers of threads which have exited, which are reused by new threads, as the thread pools are short-lived.
+  std::vector<Buffer*> unused{};
+  std::size_t capacity{std::size_t(1) << 16};
+  const Trace::time_point_t start{Trace::now()};
+
+  Buffer* acquire() {
+    std::lock_guard guard{mutex};
+    if (not unused.empty()) {
+      Buffer* buffer{unused.back()};
+      unused.pop_back();
+      return buffer;
+    }
+    const std::size_t id{buffers.size()};
+    buffers.push_back(std::make_unique<Buffer>(id, capacity));
+    buffers.back()->name = defaultName(id);
+    return buffers.back().get();
+  }
+  void release(Buffer* buffer) {
+    std::lock_guard guard{mutex};
+    buffer->name = defaultName(buffer->id);
+    unused.push_back(buffer);
+  }
+};
+
+/**
+ * The registry is never destroyed, as threads may exit after static destruction.
+ */
+Registry& registry() {
+  static Registry* registry{new Registry};
+  return *registry;
+}
+
+struct ThreadBuffer {
+  Buffer* buffer{nullptr};
+
+  ~ThreadBuffer() {
+    if (buffer) registry().release(buffer);
+  }
+  Buffer& get() {
+    if (not buffer) buffer = registry().acquire();
+    return *buffer;
+  }
+};
+thread_local ThreadBuffer thread_buffer{};
+} // namespace
+
+std::int64_t Trace::sinceStart(time_point_t time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time - registry().start).count();
+}
+void Trace::record(const Event& event) { thread_buffer.get().push(event); }
+
+void Trace::setCapacity(std::size_t capacity) {
+  Registry& instance{registry()};
+  std::lock_guard guard{instance.mutex};
+  instance.capacity = std::max<std::size_t>(capacity, 1);
+}
+void Trace::nameThread(std::string name) {
+  Buffer& buffer{thread_buffer.get()};
+  std::lock_guard guard{registry().mutex};
+  buffer.name = std::move(name);
+}
+
+void Trace::clear() {
+  Registry& instance{registry()};
+  std::lock_guard guard{instance.mutex};
+  for (auto& buffer : instance.buffers) buffer->clear();
+}
+
+void Trace::writeChromeJson(std::ostream& stream) {
+  Registry& instance{registry()};
+  std::lock_guard guard{instance.mutex};
+  // The descriptions are computed once per node and task type, as there are many events for each of them.
+  absl::flat_hash_map<const Node*, std::string> nodes{};
+  absl::flat_hash_map<const std::type_info*, std::string> types{};
+  const auto node_name{[&nodes](const Node& node) -> const std::string& {
+    auto [it, inserted]{nodes.try_emplace(&node)};
+    if (inserted) {
+      std::ostringstream description{};
+      description << node;
+      it->second = description.str();
+    }
+    return it->second;
+  }};
+  const auto type_name{[&types](const std::type_info& type) -> const std::string& {
+    auto [it, inserted]{types.try_emplace(&type)};
+    if (inserted) it->second = boost::core::demangle(type.name());
+    return it->second;
+  }};
+
+  const auto region_name{[](const Trace::rectangle_t& region) {
+    std::ostringstream description{};
+    description << region;
+    return description.str();
+  }};
+
+  const auto flags{stream.flags()};
+  const auto precision{stream.precision(3)};
+  stream << std::fixed << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first{true};
+  for (const auto& buffer : instance.buffers) {
+    stream << (first ? "\n" : ",\n") << R"({"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << buffer->id
+           << R"(, "args": {"name": ")";
+    writeEscaped(stream, buffer->name);
+    stream << "\"}}";
+    first = false;
+    buffer->forEach([&](const Event& event) {
+      stream << ",\n{\"name\": \"" << event.name << "\", ";
+      if (event.type)
+        stream << R"("cat": "task", "ph": "X", "dur": )" << double(event.duration) / 1e3;
+      else
+        stream << R"("cat": "coordinator", "ph": "i", "s": "t")";
+      stream << ", \"ts\": " << double(event.start) / 1e3 << ", \"pid\": 1, \"tid\": " << buffer->id
+             << ", \"args\": {\"node\": \"";
+      writeEscaped(stream, node_name(*event.node));
+      stream << "\", \"region\": \"";
+      writeEscaped(stream, region_name(event.region));
+      if (event.dependency) {
+        stream << "\", \"dependency\": \"";
+        writeEscaped(stream, node_name(*event.dependency));
+        stream << "\", \"dependency_region\": \"";
+        writeEscaped(stream, region_name(event.dependency_region));
+      }
+      if (event.type) {
+        stream << "\", \"task\": \"";
+        writeEscaped(stream, type_name(*event.type));
+      }
+      stream << "\"}}";
+    });
+  }
+  stream << "\n]}\n";
+  stream.precision(precision);
+  stream.flags(flags);
+}
@@ -0,0 +1,127 @@
+#include "internal/typing/BulkConversion.hpp"
+#include "internal/typing/NumberConversion.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#endif
+
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+/*
+ * Every conversion is compiled for several instruction sets, one of which is chosen by the loader depending on the
+ * CPU, so the library itself does not have to be compiled for a specific CPU.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+#define __BULK_CONVERSION_TARGETS __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+#define __BULK_CONVERSION_TARGETS
+#endif
+
+namespace {
+constexpr std::size_t chunk_size{1024};
+
+#if defined(__x86_64__) && defined(__GNUC__)
+const bool has_f16c{(__builtin_cpu_init(), __builtin_cpu_supports("f16c") != 0)};
+
+__attribute__((target("avx,f16c"))) void widen_f16c(const float16_t* input, float32_t* output, std::size_t size) {
+  std::size_t i{0};
+  for (; i + 8 <= size; i += 8)
+    _mm256_storeu_ps(output + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))));
+  for (; i < size; ++i) output[i] = _cvtsh_ss(input[i].bits());
+}
+
+__attribute__((target("avx,f16c"))) void narrow_f16c(const float32_t* input, float16_t* output, std::size_t size) {
+  std::size_t i{0};
+  for (; i + 8 <= size; i += 8)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT));
+  for (; i < size; ++i) output[i] = float16_t::fromBits(std::uint16_t(_cvtss_sh(input[i], _MM_FROUND_TO_NEAREST_INT)));
+}
+#endif
+
+/**
+ * Converts between float16_t and float32_t using F16C if the CPU supports it.
+ */
+inline void widen(const float16_t* input, float32_t* output, std::size_t size) {
+#if defined(__x86_64__) && defined(__GNUC__)
+  if (has_f16c) return widen_f16c(input, output, size);
+#endif
+  for (std::size_t i{0}; i < size; ++i) output[i] = float32_t(input[i]);
+}
+inline void narrow(const float32_t* input, float16_t* output, std::size_t size) {
+#if defined(__x86_64__) && defined(__GNUC__)
+  if (has_f16c) return narrow_f16c(input, output, size);
+#endif
+  for (std::size_t i{0}; i < size; ++i) output[i] = float16_t(input[i]);
+}
+
+/*
+ * Conversions from or to float16_t are performed through float32_t in chunks, so that F16C can be used.
+ */
+template<typename OutputType, typename InputType>
+inline void convert_bulk(const InputType* input, OutputType* output, std::size_t size) {
+  if constexpr (std::is_same_v<InputType, OutputType>) {
+    if (input != output) std::memmove(output, input, size * sizeof(OutputType));
+  } else if constexpr (std::is_same_v<InputType, float16_t> and std::is_same_v<OutputType, float32_t>)
+    widen(input, output, size);
+  else if constexpr (std::is_same_v<InputType, float16_t>) {
+    std::array<float32_t, chunk_size> buffer;
+    for (std::size_t i{0}; i < size; i += chunk_size) {
+      const std::size_t count{std::min(chunk_size, size - i)};
+      widen(input + i, buffer.data(), count);
+      convert_bulk<OutputType>(buffer.data(), output + i, count);
+    }
+  } else if constexpr (std::is_same_v<OutputType, float16_t>) {
+    // The values are saturated as in saturate_cast, as F16C would round large values to infinity.
+    constexpr float32_t min{std::numeric_limits<float16_t>::lowest()}, max{std::numeric_limits<float16_t>::max()};
+    std::array<float32_t, chunk_size> buffer;
+    for (std::size_t i{0}; i < size; i += chunk_size) {
+      const std::size_t count{std::min(chunk_size, size - i)};
+      for (std::size_t j{0}; j < count; ++j)
+        buffer[j] = std::clamp(float32_t(convert_normalized<false, float32_t>(input[i + j])), min, max);
+      narrow(buffer.data(), output + i, count);
+    }
+  } else
+    for (std::size_t i{0}; i < size; ++i) output[i] = convert_normalized<false, OutputType>(input[i]);
+}
+
+template<typename OutputType, typename InputType> inline void
+convert_bulk(const InputType* input, OutputType* output, std::size_t size,
+             const least_floating_point_t<OutputType>* noise) {
+  if constexpr (std::is_same_v<InputType, OutputType>) {
+    if (input != output) std::memmove(output, input, size * sizeof(OutputType));
+  } else if constexpr (std::is_same_v<InputType, float16_t>) {
+    std::array<float32_t, chunk_size> buffer;
+    for (std::size_t i{0}; i < size; i += chunk_size) {
+      const std::size_t count{std::min(chunk_size, size - i)};
+      widen(input + i, buffer.data(), count);
+      convert_bulk<OutputType>(buffer.data(), output + i, count, noise + i);
+    }
+  } else {
+    // The same computation as in convert_normalized_dithered, with the noise taken from the array.
+    using least_t = least_common_floating_point_t<OutputType, InputType>;
+    constexpr least_t factor{least_t(white_point_v<OutputType>) / least_t(white_point_v<InputType>)};
+    for (std::size_t i{0}; i < size; ++i)
+      output[i] = saturate_cast<OutputType>(factor * input[i] + least_t(noise[i]));
+  }
+}
+} // namespace
+
+namespace ImageGraph::internal {
+#define __BULK_CONVERSION_DEFINE(IN, OUT)                                                                             \
+  __BULK_CONVERSION_TARGETS void convert_normalized_bulk(const IN* input, OUT* output, std::size_t size) {           \
+    convert_bulk<OUT>(input, output, size);                                                                          \
+  }
+#define __BULK_CONVERSION_DEFINE_DITHERED(IN, OUT)                                                                    \
+  __BULK_CONVERSION_TARGETS void convert_normalized_bulk(const IN* input, OUT* output, std::size_t size,             \
+                                                         const least_floating_point_t<OUT>* noise) {                 \
+    convert_bulk<OUT>(input, output, size, noise);                                                                   \
+  }
+#define __BULK_CONVERSION_DEFINE_INPUT(IN)                                                                            \
+  __BULK_CONVERSION_OUTPUTS(__BULK_CONVERSION_DEFINE, IN)                                                             \
+  __BULK_CONVERSION_INTEGRAL_OUTPUTS(__BULK_CONVERSION_DEFINE_DITHERED, IN)
+__BULK_CONVERSION_INPUTS(__BULK_CONVERSION_DEFINE_INPUT)
+} // namespace ImageGraph::internal
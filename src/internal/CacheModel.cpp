@@ -0,0 +1,67 @@
+#include "../../include/internal/CacheModel.hpp"
+#include <absl/container/flat_hash_set.h>
+#include <algorithm>
+
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+using out_data_map_t = ProtoGraphAdaptor::out_data_map_t;
+
+/**
+ * Appends the node after all of its inputs, resulting in the reverse order of the model.
+ */
+void postOrder(const OutNode* node, const out_data_map_t& out_data, absl::flat_hash_set<const OutNode*>& visited,
+               std::vector<const OutNode*>& order) {
+  if (not visited.insert(node).second) return;
+  for (const auto& input : out_data.at(node).input_requests) postOrder(input.first, out_data, visited, order);
+  order.push_back(node);
+}
+
+CacheModel::CacheModel(const ProtoGraphAdaptor& adaptor) : weighted_sink_duration_{adaptor.weightedSinkDuration()} {
+  const auto& out_data{adaptor.outData()};
+  absl::flat_hash_set<const OutNode*> visited{};
+  std::vector<const OutNode*> order{};
+  for (const auto& datum : out_data) postOrder(datum.first, out_data, visited, order);
+
+  nodes_.reserve(order.size());
+  for (auto it{order.rbegin()}; it != order.rend(); ++it) {
+    const auto& datum{out_data.at(*it)};
+    indices_.emplace(*it, nodes_.size());
+    const durrep_t duration{datum.computations ? datum.duration / durrep_t(datum.computations) : durrep_t{}};
+    nodes_.emplace_back(datum.profile, datum.sink_requests, duration);
+  }
+  for (const auto& [node, datum] : out_data) {
+    Node& model_node{nodes_[indices_.at(node)]};
+    if (not datum.weighted_computations) continue;
+    for (const auto& [input, requests] : datum.input_requests)
+      model_node.inputs.emplace_back(indices_.at(input), requests / datum.weighted_computations);
+  }
+
+  weight_t cumulative{0};
+  for (const auto& datum : adaptor.sinkData()) cumulative += datum.second.relevance;
+  if (cumulative) normalization_ = weight_t(adaptor.sinkData().size()) / cumulative;
+}
+
+void CacheModel::calibrate(const OutNode& node, weight_t miss_factor, std::optional<durrep_t> duration) {
+  auto it{indices_.find(&node)};
+  if (it == indices_.end()) return;
+  Node& model_node{nodes_[it->second]};
+  model_node.miss_factor = miss_factor;
+  if (duration) model_node.duration = *duration;
+}
+
+CacheModel::durrep_t CacheModel::cost(const std::vector<std::size_t>& capacities, std::vector<Usage>& usages) const {
+  assert(capacities.size() == nodes_.size());
+  usages.assign(nodes_.size(), {});
+  durrep_t cost{weighted_sink_duration_};
+  for (std::size_t i{0}; i < nodes_.size(); ++i) {
+    const Node& node{nodes_[i]};
+    Usage& usage{usages[i]};
+    usage.requests += node.sink_requests;
+    const weight_t miss_ratio{std::min<weight_t>(node.miss_factor * node.profile.missRatio(capacities[i]), 1)};
+    usage.computations = usage.requests * miss_ratio;
+    cost += usage.computations * node.duration;
+    for (const auto& [input, requests] : node.inputs) usages[input].requests += usage.computations * requests;
+  }
+  return normalization_ * cost;
+}
@@ -3,52 +3,91 @@
 
 using namespace ImageGraph::internal;
 
-ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::outRequest(ProtoOutTask& task, OutData& data) {
-  durrep_t own_time{}, dep_time{};
+void ProtoGraphAdaptor::profile(const OutNode& node, OutData& data, rectangle_t region) {
+  if (node.memoryMode() == MemoryMode::ANY_MEMORY and node.isCacheable(region))
+    data.profile.access(region, node.regionBytes(region), weight_);
+  else
+    data.profile.miss(weight_);
+}
+
+ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::schedule(durrep_t ready, durrep_t duration) {
+  const durrep_t finish{std::max(ready, workers_.top()) + duration};
+  workers_.pop();
+  workers_.push(finish);
+  makespan_ = std::max(makespan_, finish);
+  return finish;
+}
+
+ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::outRequest(ProtoOutTask& task, OutData& data, durrep_t& finish) {
+  durrep_t own_time{}, dep_time{}, ready{0};
   // TODO This could depend on the input index!
   const durrep_t single_time{std::chrono::duration_cast<duration_t>(task.singleTime()).count()};
 
   // Time to perform dependencies
-  task.performRequiredTasks([this, &task, &own_time, &dep_time, single_time](const OutNode& node, rectangle_t region) {
+  task.performRequiredTasks([this, &task, &own_time, &dep_time, &ready, single_time,
+                             &consumer = data](const OutNode& requested, rectangle_t region) {
+    const OutNode& node{requested.outputNode()};
     OutData& data{out_data_.at(&node)};
     ++data.requests;
+    consumer.input_requests[&node] += weight_;
+    profile(node, data, region);
     if (node.memoryMode() != MemoryMode::ANY_MEMORY or not data.cache->contains(region)) {
       ++data.computations;
+      data.weighted_computations += weight_;
       std::unique_ptr<ProtoOutTask> new_task{node.protoTask(region)};
       assert(new_task);
       ProtoOutTask& ref{*new_task};
-      dep_time += outRequest(ref, data);
-    }
+      durrep_t input_finish{};
+      dep_time += outRequest(ref, data, input_finish);
+      ready = std::max(ready, input_finish);
+    } else if (auto it{data.available.find(region)}; it != data.available.end())
+      ready = std::max(ready, it->second);
     own_time += single_time;
   });
 
   // Time to perform the task itself.
   const OutNode& node{task.node()};
   const auto region{task.region()};
-  if (node.memoryMode() == MemoryMode::ANY_MEMORY and node.isCacheable(region)) data.cache->put(region);
   own_time += std::chrono::duration_cast<duration_t>(task.fullTime()).count();
   data.duration += own_time;
+  finish = schedule(ready, own_time);
+  if (node.memoryMode() == MemoryMode::ANY_MEMORY and node.isCacheable(region)) {
+    data.cache->put(region, node.regionBytes(region));
+    data.available.insert_or_assign(region, finish);
+  }
 
   return own_time + dep_time;
 }
 
 ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::sinkRequest(ProtoSinkTask& task) {
   durrep_t time{};
-  auto [node, region]{task.nextRequiredTask()};
+  auto [requested, region]{task.nextRequiredTask()};
+  const OutNode& node{requested.outputNode()};
+
+  SinkData& sink_datum{sink_data_.at(&task.node())};
+  weight_ = sink_datum.relevance;
 
   OutData& data{out_data_.at(&node)};
   ++data.requests;
+  data.sink_requests += weight_;
+  profile(node, data, region);
+  SinkProgress& progress{sink_progress_[&task]};
+  durrep_t& ready{progress.ready};
   if (node.memoryMode() != MemoryMode::ANY_MEMORY or not data.cache->contains(region)) {
     ++data.computations;
+    data.weighted_computations += weight_;
 
     std::unique_ptr<ProtoOutTask> new_task{node.protoTask(region)};
     assert(new_task);
     ProtoOutTask& ref{*new_task};
-    time += outRequest(ref, data);
-  }
+    durrep_t finish{};
+    time += outRequest(ref, data, finish);
+    ready = std::max(ready, finish);
+  } else if (auto it{data.available.find(region)}; it != data.available.end())
+    ready = std::max(ready, it->second);
+  if (++progress.requests == first_tiles_) sink_datum.first_completion = std::max(sink_datum.first_completion, ready);
 
   const durrep_t single_time{std::chrono::duration_cast<duration_t>(task.singleTime()).count()};
-  SinkData& sink_datum{sink_data_.at(&task.node())};
   if (task.allGenerated()) {
     chooser_.eraseSinkTask(task);
     time += sinkPerformable(task);
@@ -61,6 +100,17 @@ ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::sinkPerformable(ProtoSinkTask& ta
   assert(not chooser_.contains(task));
 
   const auto time{std::chrono::duration_cast<duration_t>(task.fullTime()).count()};
+  SinkData& datum{sink_data_.at(&task.node())};
+  weighted_sink_duration_ += datum.relevance * time;
+
+  SinkProgress progress{};
+  if (auto it{sink_progress_.find(&task)}; it != sink_progress_.end()) {
+    progress = it->second;
+    sink_progress_.erase(it);
+  }
+  datum.completion = std::max(datum.completion, schedule(progress.ready, time));
+  // A sink with fewer tiles is complete with its last one.
+  if (progress.requests < first_tiles_) datum.first_completion = std::max(datum.first_completion, progress.ready);
 
   BorrowedPtr ptr{&task};
   sink_tasks_.erase(ptr);
@@ -68,9 +118,9 @@ ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::sinkPerformable(ProtoSinkTask& ta
   return time;
 }
 
-ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::addOutNode(const OutNode& node, std::size_t capacity) {
+ProtoGraphAdaptor::durrep_t ProtoGraphAdaptor::addOutNode(const OutNode& node, std::size_t cache_bytes) {
   auto proto_cache{node.createProtoCache()};
-  if (node.memoryMode() == MemoryMode::ANY_MEMORY) proto_cache->resize(capacity);
+  if (node.memoryMode() == MemoryMode::ANY_MEMORY) proto_cache->resize(cache_bytes);
   out_data_.emplace(&node, OutData(std::move(proto_cache)));
   return 0;
 }
@@ -0,0 +1,166 @@
+#include "internal/TilePool.hpp"
+#include "core/Metrics.hpp"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace ImageGraph::internal;
+
+namespace {
+constexpr std::size_t min_class_bits{std::bit_width(TilePool::alignment) - 1};
+
+constexpr std::size_t classIndex(std::size_t bytes) {
+  return bytes <= TilePool::alignment ? 0 : std::size_t(std::bit_width(bytes - 1)) - min_class_bits;
+}
+constexpr std::size_t classSize(std::size_t index) { return std::size_t(1) << (index + min_class_bits); }
+
+void* newBuffer(std::size_t bytes) { return ::operator new(bytes, std::align_val_t{TilePool::alignment}); }
+void deleteBuffer(void* pointer) noexcept { ::operator delete(pointer, std::align_val_t{TilePool::alignment}); }
+
+using free_lists_t = std::array<std::vector<void*>, TilePool::class_count>;
+
+struct GlobalPool {
+  std::mutex mutex{};
+  free_lists_t buffers{};
+  std::size_t bytes{0};
+  std::size_t limit{std::size_t(256) << 20};
+
+  /**
+   * Releases buffers, starting with the largest ones, until the pool does not exceed the limit.
+   * The mutex has to be locked.
+   */
+  void shrink() {
+    for (std::size_t index{TilePool::class_count}; index-- > 0 and bytes > limit;) {
+      auto& list{buffers[index]};
+      while (not list.empty() and bytes > limit) {
+        deleteBuffer(list.back());
+        list.pop_back();
+        bytes -= classSize(index);
+      }
+    }
+  }
+
+  void* pop(std::size_t index) {
+    std::lock_guard guard{mutex};
+    auto& list{buffers[index]};
+    if (list.empty()) return nullptr;
+    void* pointer{list.back()};
+    list.pop_back();
+    bytes -= classSize(index);
+    return pointer;
+  }
+  void push(void* pointer, std::size_t index) noexcept {
+    const std::size_t size{classSize(index)};
+    {
+      std::lock_guard guard{mutex};
+      if (bytes + size <= limit) {
+        try {
+          buffers[index].push_back(pointer);
+          bytes += size;
+          return;
+        } catch (const std::bad_alloc&) {
+        }
+      }
+    }
+    deleteBuffer(pointer);
+  }
+};
+
+/**
+ * The global pool is never destroyed, as tiles may be released by threads which exit after static destruction.
+ */
+GlobalPool& globalPool() {
+  static GlobalPool* pool{new GlobalPool};
+  return *pool;
+}
+
+struct ThreadCache {
+  free_lists_t buffers{};
+  std::size_t bytes{0};
+
+  ThreadCache() {
+    for (auto& list : buffers) list.reserve(TilePool::thread_class_limit);
+  }
+  ~ThreadCache();
+
+  void* pop(std::size_t index) {
+    auto& list{buffers[index]};
+    if (list.empty()) return nullptr;
+    void* pointer{list.back()};
+    list.pop_back();
+    bytes -= classSize(index);
+    return pointer;
+  }
+  bool push(void* pointer, std::size_t index) {
+    auto& list{buffers[index]};
+    const std::size_t size{classSize(index)};
+    if (list.size() >= TilePool::thread_class_limit or bytes + size > TilePool::thread_byte_limit) return false;
+    list.push_back(pointer);
+    bytes += size;
+    return true;
+  }
+};
+
+// Whether the cache of the current thread has been destroyed, after which the global pool is used directly.
+thread_local bool thread_cache_destroyed{false};
+thread_local ThreadCache thread_cache{};
+
+ThreadCache::~ThreadCache() {
+  thread_cache_destroyed = true;
+  for (std::size_t index{0}; index < TilePool::class_count; ++index)
+    for (void* pointer : buffers[index]) globalPool().push(pointer, index);
+}
+
+ThreadCache* threadCache() { return thread_cache_destroyed ? nullptr : &thread_cache; }
+
+// The bytes of the tiles which have been allocated and not deallocated yet.
+// They are always counted, as a tile may be allocated and deallocated while the metrics are enabled in between.
+std::atomic<std::size_t> tile_bytes{0};
+
+void recordPeak(std::size_t bytes) {
+  static ImageGraph::Metrics::Gauge& peak{ImageGraph::Metrics::global().gauge(
+      "imagegraph_tile_bytes_peak", "The peak number of bytes of the tiles in use while the metrics are enabled.")};
+  peak.max(double(bytes));
+}
+} // namespace
+
+void* TilePool::allocate(std::size_t bytes) {
+  const std::size_t in_use{tile_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+  if (ImageGraph::Metrics::enabled()) recordPeak(in_use);
+  const std::size_t index{classIndex(bytes)};
+  if (index >= class_count) return newBuffer(bytes);
+  if (ThreadCache* cache{threadCache()})
+    if (void* pointer{cache->pop(index)}) return pointer;
+  if (void* pointer{globalPool().pop(index)}) return pointer;
+  return newBuffer(classSize(index));
+}
+
+void TilePool::deallocate(void* pointer, std::size_t bytes) noexcept {
+  if (not pointer) return;
+  tile_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  const std::size_t index{classIndex(bytes)};
+  if (index >= class_count) return deleteBuffer(pointer);
+  if (ThreadCache* cache{threadCache()})
+    if (cache->push(pointer, index)) return;
+  globalPool().push(pointer, index);
+}
+
+void TilePool::setGlobalLimit(std::size_t bytes) {
+  GlobalPool& pool{globalPool()};
+  std::lock_guard guard{pool.mutex};
+  pool.limit = bytes;
+  pool.shrink();
+}
+std::size_t TilePool::globalLimit() {
+  GlobalPool& pool{globalPool()};
+  std::lock_guard guard{pool.mutex};
+  return pool.limit;
+}
+std::size_t TilePool::globalBytes() {
+  GlobalPool& pool{globalPool()};
+  std::lock_guard guard{pool.mutex};
+  return pool.bytes;
+}
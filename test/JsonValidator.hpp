@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cctype>
+#include <string>
+#include <string_view>
+
+/**
+ * A minimal JSON validator, which only checks the syntax and not whether the numbers are representable.
+ */
+class JsonValidator {
+  const std::string& text_;
+  std::size_t position_{0};
+
+  void skipSpace() {
+    while (position_ < text_.size() and std::isspace(static_cast<unsigned char>(text_[position_]))) ++position_;
+  }
+  bool consume(char character) {
+    skipSpace();
+    if (position_ >= text_.size() or text_[position_] != character) return false;
+    ++position_;
+    return true;
+  }
+  bool string() {
+    if (not consume('"')) return false;
+    for (; position_ < text_.size(); ++position_) {
+      const char character{text_[position_]};
+      if (character == '"') {
+        ++position_;
+        return true;
+      }
+      if (static_cast<unsigned char>(character) < 0x20) return false;
+      if (character == '\\' and ++position_ >= text_.size()) return false;
+    }
+    return false;
+  }
+  bool number() {
+    skipSpace();
+    const std::size_t begin{position_};
+    constexpr std::string_view characters{"+-.0123456789eE"};
+    while (position_ < text_.size() and characters.find(text_[position_]) != std::string_view::npos) ++position_;
+    return position_ > begin;
+  }
+  template<typename F> bool sequence(char close, F element) {
+    if (consume(close)) return true;
+    do {
+      if (not element()) return false;
+    } while (consume(','));
+    return consume(close);
+  }
+  bool value() {
+    skipSpace();
+    if (position_ >= text_.size()) return false;
+    switch (text_[position_]) {
+      case '{': ++position_; return sequence('}', [this] { return string() and consume(':') and value(); });
+      case '[': ++position_; return sequence(']', [this] { return value(); });
+      case '"': return string();
+      default: return number();
+    }
+  }
+
+public:
+  explicit JsonValidator(const std::string& text) : text_{text} {}
+
+  bool valid() {
+    if (not value()) return false;
+    skipSpace();
+    return position_ == text_.size();
+  }
+};
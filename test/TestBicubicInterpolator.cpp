@@ -1,29 +1,83 @@
 #include "core/Rectangle.hpp"
 #include "core/Tile.hpp"
 #include "internal/BicubicInterpolator.hpp"
+#include "internal/CubicConvolution.hpp"
+#include <cmath>
 #include <iostream>
 
-int main() {
-  using namespace ImageGraph;
-  using namespace ImageGraph::internal;
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+constexpr float tolerance{1e-4f};
 
+bool check(const char* name, float x, float y, float value, float expected) {
+  if (std::abs(value - expected) <= tolerance) return true;
+  std::cerr << name << " at (" << x << ", " << y << "): " << value << " instead of " << expected << std::endl;
+  return false;
+}
+
+/**
+ * Interpolates a linear ramp and a less regular tile, checking that the spline interpolates the samples and that both
+ * the spline and the cubic convolution reproduce the ramp, the latter away from the replicated border.
+ */
+int main() {
   const std::size_t channels{3};
+  bool success{true};
 
-  Rectangle<std::size_t> in_rect{{3, 3}};
-  Tile<float> in_tile{in_rect, channels};
-  for (std::size_t j{0}; j < in_tile.height(); ++j)
-    for (std::size_t i{0}; i < in_tile.width(); ++i)
-      for (std::size_t k{0}; k < in_tile.channels(); ++k) in_tile(i, j, k) = (i * j + i + j) % (k + channels);
-  std::cout << in_tile << std::endl;
+  const Rectangle<std::size_t> in_rect{{6, 5}};
+  Tile<float> ramp{in_rect, channels}, irregular{in_rect, channels};
+  const auto ramp_value{[](float x, float y, std::size_t k) { return 2.f * x - 3.f * y + float(k); }};
+  for (std::size_t j{0}; j < in_rect.height(); ++j)
+    for (std::size_t i{0}; i < in_rect.width(); ++i)
+      for (std::size_t k{0}; k < channels; ++k) {
+        ramp(i, j, k) = ramp_value(float(i), float(j), k);
+        irregular(i, j, k) = float((i * j + i + j) % (k + channels));
+      }
 
-  BicubicInterpolator<float, float, Tile> interpolator{in_tile, [](float value) { return value; }};
+  const BicubicInterpolator<float, float, Tile> ramp_spline{ramp, [](float value) { return value; }},
+      irregular_spline{irregular, [](float value) { return value; }};
+  for (std::size_t j{0}; j < in_rect.height(); ++j)
+    for (std::size_t i{0}; i < in_rect.width(); ++i)
+      for (std::size_t k{0}; k < channels; ++k)
+        success &= check("spline sample", float(i), float(j), irregular_spline.evaluate(float(i), float(j), k),
+                         irregular(i, j, k));
+  for (float y{0}; y <= float(in_rect.height() - 1); y += .25f)
+    for (float x{0}; x <= float(in_rect.width() - 1); x += .25f)
+      for (std::size_t k{0}; k < channels; ++k)
+        success &= check("spline ramp", x, y, ramp_spline.evaluate(x, y, k), ramp_value(x, y, k));
 
-  Rectangle<std::size_t> out_rect{{6, 6}};
-  Tile<float> out_tile{out_rect, channels};
-  for (std::size_t j{0}; j < out_tile.height(); ++j)
-    for (std::size_t i{0}; i < out_tile.width(); ++i)
-      for (std::size_t k{0}; k < out_tile.channels(); ++k) out_tile(i, j, k) = interpolator.evaluate(.5 * i, .5 * j, k);
-  std::cout << out_tile << std::endl;
+  // With a scale of 1/2, output pixel i is centered on the input position (i + 1/2) / 2 - 1/2, and its taps are not
+  // clamped if that position lies within [1, size - 2).
+  const Rectangle<std::size_t> out_rect{{2 * in_rect.width(), 2 * in_rect.height()}};
+  const CubicConvolutionAxis<float> axis_x{0, out_rect.width(), .5f, 0, in_rect.width()},
+      axis_y{0, out_rect.height(), .5f, 0, in_rect.height()};
+  const auto interior{[](std::size_t i, std::size_t size) {
+    const float position{.5f * (float(i) + .5f) - .5f};
+    return position >= 1.f and position < float(size) - 2.f;
+  }};
+  std::size_t interior_count{0};
+  for (std::size_t j{0}; j < out_rect.height(); ++j)
+    for (std::size_t i{0}; i < out_rect.width(); ++i)
+      for (std::size_t k{0}; k < channels; ++k) {
+        float value{0}, weight_sum{0};
+        for (std::size_t y{0}; y < CubicConvolutionAxis<float>::taps; ++y)
+          for (std::size_t x{0}; x < CubicConvolutionAxis<float>::taps; ++x) {
+            const float weight{axis_y.weights(j)[y] * axis_x.weights(i)[x]};
+            value += weight * ramp(axis_x.indices(i)[x], axis_y.indices(j)[y], k);
+            weight_sum += weight;
+          }
+        const float x{.5f * (float(i) + .5f) - .5f}, y{.5f * (float(j) + .5f) - .5f};
+        success &= check("convolution weights", x, y, weight_sum, 1.f);
+        if (interior(i, in_rect.width()) and interior(j, in_rect.height())) {
+          success &= check("convolution ramp", x, y, value, ramp_value(x, y, k));
+          ++interior_count;
+        }
+      }
+  if (not interior_count) {
+    std::cerr << "No output pixel is away from the border!" << std::endl;
+    success = false;
+  }
 
-  return 0;
+  std::cout << (success ? "All interpolated values match." : "Some interpolated values do not match!") << std::endl;
+  return success ? 0 : 1;
 }
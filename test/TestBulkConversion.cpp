@@ -0,0 +1,113 @@
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/PerTwoPixels.hpp"
+#include "internal/typing/BulkConversion.hpp"
+#include "internal/typing/NumberConversion.hpp"
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+/**
+ * A generator returning the given noise in order, so that the scalar conversion uses the same noise as the bulk one.
+ */
+template<typename T> struct NoiseReplay {
+  const T* noise;
+};
+template<typename N, typename T> static inline N random_norm(NoiseReplay<T>& replay) { return N(*replay.noise++); }
+
+/**
+ * @return The number of values which the bulk conversion converts differently than the scalar one.
+ */
+template<typename OutputType, typename InputType> std::size_t compare(const std::vector<InputType>& input) {
+  const std::size_t size{input.size()};
+  std::vector<OutputType> bulk(size), scalar(size);
+
+  convert_normalized_bulk(input.data(), bulk.data(), size);
+  for (std::size_t i{0}; i < size; ++i) scalar[i] = convert_normalized<false, OutputType>(input[i]);
+  std::size_t mismatches{0};
+  for (std::size_t i{0}; i < size; ++i) mismatches += bulk[i] != scalar[i];
+
+  if constexpr (is_integral_v<OutputType>) {
+    using noise_t = least_floating_point_t<OutputType>;
+    std::vector<noise_t> noise(size);
+    for (std::size_t i{0}; i < size; ++i) noise[i] = noise_t(i % 16) / noise_t(16);
+    convert_normalized_bulk(input.data(), bulk.data(), size, noise.data());
+    NoiseReplay<noise_t> replay{noise.data()};
+    for (std::size_t i{0}; i < size; ++i) scalar[i] = convert_normalized<true, OutputType>(input[i], replay);
+    for (std::size_t i{0}; i < size; ++i) mismatches += bulk[i] != scalar[i];
+  }
+
+  std::cout << type_name<InputType>() << " → " << type_name<OutputType>() << ": " << mismatches << " mismatches"
+            << std::endl;
+  return mismatches;
+}
+
+/**
+ * @return The number of values which the bulk computation of the callable computes differently than the scalar one,
+ * where vectorized functions like pow may differ from the scalar ones by up to the tolerance.
+ */
+template<typename OutputType, template<typename, typename> typename Callable, typename InputType, typename... Args>
+std::size_t compareCallable(const char* name, const std::vector<InputType>& input, double tolerance, Args... args) {
+  using call_t = Callable<InputType, OutputType>;
+  const typename call_t::args_t attributes{args...};
+  const std::size_t size{input.size()};
+  std::vector<OutputType> bulk(size);
+  call_t::computeBulk(input.data(), bulk.data(), size, attributes);
+  std::size_t mismatches{0};
+  for (std::size_t i{0}; i < size; ++i)
+    mismatches += std::abs(double(bulk[i]) - double(call_t::template compute<false>(input[i], attributes))) > tolerance;
+  std::cout << name << "<" << type_name<InputType>() << ", " << type_name<OutputType>() << ">: " << mismatches
+            << " mismatches" << std::endl;
+  return mismatches;
+}
+
+template<typename OutputType, template<typename, typename, typename> typename Callable, typename In1, typename In2>
+std::size_t compareCallable(const char* name, const std::vector<In1>& in1, const std::vector<In2>& in2) {
+  using call_t = Callable<In1, In2, OutputType>;
+  const std::size_t size{in1.size()};
+  std::vector<OutputType> bulk(size);
+  call_t::computeBulk(in1.data(), in2.data(), bulk.data(), size, {});
+  std::size_t mismatches{0};
+  for (std::size_t i{0}; i < size; ++i)
+    mismatches += bulk[i] != call_t::template compute<false>(in1[i], in2[i], {});
+  std::cout << name << "<" << type_name<In1>() << ", " << type_name<In2>() << ", " << type_name<OutputType>()
+            << ">: " << mismatches << " mismatches" << std::endl;
+  return mismatches;
+}
+
+int main() {
+  std::vector<float32_t> floats(1000);
+  for (std::size_t i{0}; i < floats.size(); ++i) floats[i] = float32_t(i) / 900.f - .05f;
+  std::vector<std::uint16_t> shorts(1000);
+  for (std::size_t i{0}; i < shorts.size(); ++i) shorts[i] = std::uint16_t(i * 65);
+
+  std::vector<float16_t> halves(floats.begin(), floats.end());
+
+  std::size_t mismatches{0};
+  mismatches += compare<std::uint8_t>(floats);
+  mismatches += compare<std::int16_t>(floats);
+  mismatches += compare<float64_t>(floats);
+  mismatches += compare<float16_t>(floats);
+  mismatches += compare<std::uint8_t>(shorts);
+  mismatches += compare<float32_t>(shorts);
+  mismatches += compare<float16_t>(shorts);
+  mismatches += compare<std::uint16_t>(shorts);
+  mismatches += compare<std::uint8_t>(halves);
+  mismatches += compare<float32_t>(halves);
+
+  std::vector<std::uint8_t> bytes(1000);
+  for (std::size_t i{0}; i < bytes.size(); ++i) bytes[i] = std::uint8_t(i * 7);
+  using namespace ImageGraph::nodes;
+  mismatches += compareCallable<std::uint8_t, LinearCallable>("Linear", bytes, 0, .5f, .25f);
+  mismatches += compareCallable<float32_t, LinearCallable>("Linear", shorts, 0, 2.f, -.5f);
+  mismatches += compareCallable<std::uint8_t, GammaCallable>("Gamma", bytes, 1, 2.2f);
+  mismatches += compareCallable<float16_t, GammaCallable>("Gamma", halves, 1e-3, .45f);
+  mismatches += compareCallable<float32_t, AdditionCallable>("Addition", bytes, halves);
+  mismatches += compareCallable<float64_t, SubtractionCallable>("Subtraction", floats, shorts);
+  mismatches += compareCallable<std::uint8_t, MultiplicationCallable>("Multiplication", bytes, floats);
+  mismatches += compareCallable<std::uint16_t, DivisionCallable>("Division", shorts, bytes);
+  return mismatches != 0;
+}
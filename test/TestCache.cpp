@@ -1,10 +1,15 @@
+#include "core/Tile.hpp"
 #include "internal/Cache.hpp"
+#include "internal/CacheManager.hpp"
+#include "internal/GreedyDualCache.hpp"
+#include "internal/SpatialCache.hpp"
+#include "internal/StackDistance.hpp"
 #include <iostream>
 
 int main() {
   using namespace ImageGraph::internal;
 
-  OrderedMapCache<size_t, size_t> cache(4);
+  OrderedMapCache<size_t, size_t> cache(4 * sizeof(size_t));
   std::cout << cache << std::endl;
   cache.put(0, 1);
   std::cout << cache << std::endl;
@@ -22,7 +27,7 @@ int main() {
   std::cout << cache << std::endl;
   std::cout << cache.get(1).get() << std::endl;
   std::cout << cache << std::endl;
-  cache.resize(8);
+  cache.resize(8 * sizeof(size_t));
   std::cout << cache << std::endl;
   cache.put(5, 32);
   std::cout << cache << std::endl;
@@ -35,5 +40,66 @@ int main() {
   cache.put(1, 12);
   std::cout << cache << std::endl;
 
+  using rectangle_t = ImageGraph::Rectangle<std::size_t>;
+  using tile_t = ImageGraph::Tile<float>;
+  SpatialCache<rectangle_t, tile_t> spatial_cache(4 * 32 * 32 * sizeof(float));
+  for (std::size_t y{0}; y < 64; y += 32)
+    for (std::size_t x{0}; x < 64; x += 32) {
+      tile_t tile{{{x, y}, {32, 32}}, 1};
+      for (std::size_t j{0}; j < 32; ++j)
+        for (std::size_t i{0}; i < 32; ++i) tile(i, j, 0) = float(64 * (y + j) + x + i);
+      spatial_cache.put(tile.rectangle(), std::move(tile));
+    }
+  // The exact tile, a subset of a tile, a region covered by all tiles and a region exceeding them.
+  for (const rectangle_t rectangle : {rectangle_t{{32, 0}, {32, 32}}, rectangle_t{{4, 36}, {8, 8}},
+                                      rectangle_t{{16, 16}, {32, 32}}, rectangle_t{{48, 48}, {32, 32}}}) {
+    const auto tile{spatial_cache.get(rectangle)};
+    std::cout << rectangle << ": ";
+    if (tile)
+      std::cout << (*tile)(0, 0, 0) << " " << (*tile)(tile->width() - 1, tile->height() - 1, 0) << std::endl;
+    else
+      std::cout << "miss" << std::endl;
+  }
+
+  // Even keys are ten times as expensive to recompute as odd keys, so they are kept although they are used less.
+  GreedyDualCache<size_t, size_t> weighted_cache(4 * sizeof(size_t),
+                                                 [](const size_t& key) { return key % 2 ? 1. : 10.; });
+  for (size_t i{0}; i < 4; ++i) weighted_cache.put(i, i * i);
+  auto weighted_proto_cache{weighted_cache.toProtoCache()};
+  for (size_t i{4}; i < 12; ++i) {
+    weighted_cache.get(1);
+    weighted_proto_cache->contains(1);
+    weighted_cache.put(i, i * i);
+    weighted_proto_cache->put(i, sizeof(size_t));
+  }
+  std::cout << weighted_cache << std::endl;
+  for (size_t i{0}; i < 12; ++i)
+    std::cout << bool(weighted_cache.get(i)) << weighted_proto_cache->contains(i) << (i + 1 < 12 ? " " : "\n");
+
+  // Both caches add 4 KiB to the budget, but only the first one is used in the second phase, so it takes over.
+  using bytes_t = std::vector<unsigned char>;
+  CacheManager<size_t> manager{};
+  ManagedCache<size_t, bytes_t> first_cache(4096, {}, manager), second_cache(4096, {}, manager);
+  for (size_t i{0}; i < 4; ++i) first_cache.put(i, bytes_t(1024)), second_cache.put(i, bytes_t(1024));
+  for (size_t i{4}; i < 8; ++i) {
+    for (size_t j{0}; j < i; ++j) first_cache.get(j);
+    first_cache.put(i, bytes_t(1024));
+  }
+  std::cout << first_cache.size() << " + " << second_cache.size() << " bytes using " << manager.used() << " / "
+            << manager.budget() << " bytes" << std::endl;
+
+  // A single pass yields the misses of a least recently used cache of every capacity, which are also simulated.
+  const std::vector<size_t> accesses{0, 1, 2, 0, 3, 1, 4, 0, 2, 5, 3, 0, 1, 6, 2, 0};
+  StackDistanceProfile<size_t> profile{};
+  for (size_t key : accesses) profile.access(key, (key % 2 + 1) * sizeof(size_t));
+  profile.finish();
+  for (size_t capacity{0}; capacity <= 8; ++capacity) {
+    OrderedMapProtoCache<size_t> proto_cache(capacity * sizeof(size_t));
+    size_t misses{0};
+    for (size_t key : accesses)
+      if (not proto_cache.contains(key)) ++misses, proto_cache.put(key, (key % 2 + 1) * sizeof(size_t));
+    std::cout << profile.misses(capacity * sizeof(size_t)) << "/" << misses << (capacity < 8 ? " " : "\n");
+  }
+
   return 0;
 }
@@ -0,0 +1,104 @@
+#include "core/MemoryDistribution.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/SimpleSink.hpp"
+#include <iostream>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using rectangle_t = Node::rectangle_t;
+
+/**
+ * A constant source, which is kept in full memory like a loaded image.
+ */
+struct ConstantNode final : public TiledInputOutputNode<float32_t> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final { return stream << "[ConstantNode @ " << this << "]"; }
+
+public:
+  void compute(std::tuple<>, Tile<float32_t>& output) const final { std::fill(output.begin(), output.end(), .5f); }
+
+  ConstantNode(Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(float32_t)) {}
+};
+
+struct DiscardingSinkNode final : public SimpleSinkNode<float32_t> {
+  const relevance_t relevance_;
+
+protected:
+  void handleTile(std::shared_ptr<Tile<float32_t>>) const final {}
+
+public:
+  DiscardingSinkNode(OutputNode<float32_t>& input, relevance_t relevance)
+      : SimpleSinkNode{input}, relevance_{relevance} {}
+  relevance_t relevance() const final { return relevance_; }
+};
+
+/**
+ * @return A cost model whose duration is proportional to the number of pixels, so that the plans do not depend on the
+ *         measured durations.
+ */
+internal::TileCostModel costModel(double seconds_per_pixel) {
+  internal::TileCostModel model{};
+  for (std::size_t pixels : {256, 1024, 4096, 16384})
+    model.observe(internal::TileCostModel::features(pixels, 0), seconds_per_pixel * double(pixels));
+  return model;
+}
+
+std::size_t bytesOf(const MemoryDistribution& distribution, const OutNode& node) {
+  for (const auto& info : distribution.cacheNodes())
+    if (&info.node == &node) return info.byte_num;
+  return 0;
+}
+
+/**
+ * Two sinks of different relevance request the same node, so that the tiles the more relevant one has requested are
+ * only requested again by the other one much later, which a cache only saves if it holds most of the node, while the
+ * first tiles of both sinks are requested close together. The bytes are initially spread over this node and several
+ * nodes requested by a single sink each, which leaves too few bytes for the first tiles. Optimizing the time until the
+ * first tiles are complete only has to cache these, whereas optimizing the CPU time assigns the whole node.
+ */
+int main() {
+  constexpr std::size_t size{256}, first_tiles{16}, single_num{7};
+  NodeGraph graph{};
+  auto& source{graph.createOutNode<ConstantNode>(Node::dimensions_t{size, size})};
+  auto& shared{graph.createOutNode<GammaNode<float32_t, float32_t>>(source, false, 2.2f)};
+  shared.loadCostModel(costModel(1e-6));
+  graph.createSinkNode<DiscardingSinkNode>(shared, 1.);
+  graph.createSinkNode<DiscardingSinkNode>(shared, 4.);
+  for (std::size_t i{0}; i < single_num; ++i) {
+    auto& single{graph.createOutNode<LinearNode<float32_t, float32_t>>(source, false, 1.5f, float32_t(i))};
+    single.loadCostModel(costModel(1e-6));
+    graph.createSinkNode<DiscardingSinkNode>(single, 1.);
+  }
+
+  // The source is kept in full memory, and the remaining bytes could cache one of the other nodes completely.
+  const std::size_t bytes{size * size * sizeof(float32_t)}, memory_limit{2 * bytes};
+  const auto throughput{graph.optimizeMemoryDistribution(memory_limit, NodeGraph::Planner::GREEDY, 1, 0)},
+      latency{graph.optimizeMemoryDistribution(memory_limit, NodeGraph::Planner::GREEDY, 1, 0, 1, first_tiles)};
+  const MemoryDistribution initial{memory_limit, graph.outNodes(), graph.sinkNodes(), 1, first_tiles};
+  const auto initial_cost{initial.cost()}, latency_cost{latency.cost()};
+  const std::size_t throughput_bytes{bytesOf(throughput, shared)}, latency_bytes{bytesOf(latency, shared)};
+  std::cout << "initially " << bytesOf(initial, shared) << " bytes, throughput plan: " << throughput_bytes
+            << " bytes, first tiles plan: " << latency_bytes << " bytes" << std::endl;
+  if (latency_cost >= initial_cost) {
+    std::cerr << "The time until the first tiles are complete is not reduced: " << latency_cost << " instead of "
+              << initial_cost << "!" << std::endl;
+    return 1;
+  }
+  if (latency_bytes >= throughput_bytes) {
+    std::cerr << "The plan for the first tiles does not differ from the plan for the CPU time!" << std::endl;
+    return 1;
+  }
+}
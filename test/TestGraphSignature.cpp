@@ -0,0 +1,73 @@
+#include "core/ExecutionPlan.hpp"
+#include "core/NodeGraph.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/FileSink.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "internal/Json.hpp"
+#include <iostream>
+#include <string>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using rectangle_t = Node::rectangle_t;
+
+/**
+ * A constant source described by a path, like a loaded image.
+ */
+struct PathNode final : public TiledInputOutputNode<std::uint8_t> {
+  const std::string path;
+
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final {
+    stream << "[PathNode(path=\"";
+    internal::writeEscaped(stream, path);
+    return stream << "\") @ " << this << "]";
+  }
+
+public:
+  void compute(std::tuple<>, Tile<std::uint8_t>& output) const final { std::fill(output.begin(), output.end(), 0); }
+
+  PathNode(std::string path, Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(std::uint8_t)), path{std::move(path)} {}
+};
+
+GraphSignature::signature_t signature(const std::string& input, const std::string& output, float gamma) {
+  NodeGraph graph{};
+  auto& source{graph.createOutNode<PathNode>(input, Node::dimensions_t{64, 64})};
+  auto& node{graph.createOutNode<GammaNode<std::uint8_t, std::uint8_t>>(source, false, gamma)};
+  graph.createSinkNode<FileSinkNode<std::uint8_t>>(node, output);
+  const GraphSignature::signature_t result{GraphSignature{graph}.signature()};
+  std::cout << input << ", " << output << ", " << gamma << ": " << std::hex << result << std::dec << std::endl;
+  return result;
+}
+
+/**
+ * Two graphs which only differ in the paths of their files have to have the same signature, so that a saved plan is
+ * reused for other files, while a different parameter has to change it.
+ */
+int main() {
+  const auto first{signature("first.png", "first-out.png", 2.2f)},
+      second{signature("/images/second \"copy\".jpg", "second-out.tif", 2.2f)},
+      other{signature("first.png", "first-out.png", 1.8f)};
+  bool success{true};
+  if (first != second) {
+    std::cerr << "The signature depends on the paths!" << std::endl;
+    success = false;
+  }
+  if (first == other) {
+    std::cerr << "The signature does not depend on the parameters!" << std::endl;
+    success = false;
+  }
+  return success ? 0 : 1;
+}
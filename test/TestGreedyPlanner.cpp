@@ -0,0 +1,86 @@
+#include "core/MemoryDistribution.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/SimpleSink.hpp"
+#include <cmath>
+#include <iostream>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using rectangle_t = Node::rectangle_t;
+
+/**
+ * A constant source, which is kept in full memory like a loaded image.
+ */
+struct ConstantNode final : public TiledInputOutputNode<float32_t> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final { return stream << "[ConstantNode @ " << this << "]"; }
+
+public:
+  void compute(std::tuple<>, Tile<float32_t>& output) const final { std::fill(output.begin(), output.end(), .5f); }
+
+  ConstantNode(Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(float32_t)) {}
+};
+
+struct DiscardingSinkNode final : public SimpleSinkNode<float32_t> {
+protected:
+  void handleTile(std::shared_ptr<Tile<float32_t>>) const final {}
+
+public:
+  using SimpleSinkNode::SimpleSinkNode;
+  relevance_t relevance() const final { return 1; }
+};
+
+/**
+ * @return The number of bytes assigned by the distribution, which has to have a finite cost.
+ */
+std::size_t assignedBytes(const MemoryDistribution& distribution) {
+  std::size_t assigned{0};
+  for (const auto& info : distribution.cacheNodes()) {
+    std::cout << info.node << ": " << info.byte_num << " / " << info.max_byte_num << std::endl;
+    assigned += info.byte_num;
+  }
+  const auto cost{distribution.cost()};
+  std::cout << "assigned " << assigned << " bytes at cost " << cost << std::endl;
+  return std::isfinite(cost) ? assigned : 0;
+}
+
+/**
+ * Plans a chain of nodes none of which is important for caching and whose last node is requested by two sinks, which
+ * the greedy planner used to leave without any cache bytes because the portion of wasted bytes of an empty
+ * distribution was not a number.
+ */
+int main() {
+  constexpr std::size_t size{256};
+  NodeGraph graph{};
+  auto& source{graph.createOutNode<ConstantNode>(Node::dimensions_t{size, size})};
+  auto& gamma{graph.createOutNode<GammaNode<float32_t, float32_t>>(source, false, 2.2f)};
+  auto& linear{graph.createOutNode<LinearNode<float32_t, float32_t>>(gamma, false, 1.5f, -.25f)};
+  auto& clamp{graph.createOutNode<ClampNode<float32_t, float32_t>>(linear, false, .25f, .75f)};
+  graph.createSinkNode<DiscardingSinkNode>(clamp);
+  graph.createSinkNode<DiscardingSinkNode>(clamp);
+
+  const std::size_t bytes{size * size * sizeof(float32_t)}, memory_limit{bytes + bytes / 2};
+  MemoryDistribution distribution{memory_limit, graph.outNodes(), graph.sinkNodes()};
+  distribution.cost();
+  if (not assignedBytes(distribution.greedy(distribution.buildModel()).simulated())) {
+    std::cerr << "The greedy planner did not assign any bytes!" << std::endl;
+    return 1;
+  }
+  if (not assignedBytes(graph.optimizeMemoryDistribution(memory_limit, NodeGraph::Planner::GREEDY, 1, 0))) {
+    std::cerr << "The planned distribution does not assign any bytes!" << std::endl;
+    return 1;
+  }
+}
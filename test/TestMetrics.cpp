@@ -0,0 +1,125 @@
+#include "JsonValidator.hpp"
+#include "core/Metrics.hpp"
+#include "core/NodeGraph.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/SimpleSink.hpp"
+#include "internal/TilePool.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using rectangle_t = Node::rectangle_t;
+
+/**
+ * A constant source, which is kept in full memory like a loaded image.
+ */
+struct ConstantNode final : public TiledInputOutputNode<float32_t> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final { return stream << "[ConstantNode @ " << this << "]"; }
+
+public:
+  void compute(std::tuple<>, Tile<float32_t>& output) const final { std::fill(output.begin(), output.end(), .5f); }
+
+  ConstantNode(Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(float32_t)) {}
+};
+
+struct DiscardingSinkNode final : public SimpleSinkNode<float32_t> {
+protected:
+  void handleTile(std::shared_ptr<Tile<float32_t>>) const final {}
+
+public:
+  using SimpleSinkNode::SimpleSinkNode;
+  relevance_t relevance() const final { return 1; }
+};
+
+bool contains(const std::string& text, const std::string& part) {
+  if (text.find(part) != std::string::npos) return true;
+  std::cerr << "The output does not contain: " << part << std::endl;
+  return false;
+}
+
+/**
+ * Writes a registry with every type of metric, including labels which have to be escaped, and checks both formats.
+ * Then checks that the peak of the tile bytes includes tiles allocated before the metrics have been enabled, and that
+ * the nodes of a computed graph are labelled without addresses, where equal nodes are told apart by an index.
+ */
+int main() {
+  Metrics metrics{};
+  metrics.counter("test_requests_total", "The number of \"requests\".", {{"node", "a\"b\\c"}}).add(3);
+  metrics.gauge("test_bytes", "The number of bytes.").set(1.5);
+  auto& histogram{metrics.histogram("test_seconds", "The durations.", {{"node", "n"}}, {1, 2})};
+  histogram.observe(.5);
+  histogram.observe(1.5);
+  histogram.observe(4);
+
+  std::ostringstream json{};
+  metrics.writeJson(json);
+  std::cout << json.str();
+  bool success{JsonValidator{json.str()}.valid()};
+  if (not success) std::cerr << "The JSON output does not parse!" << std::endl;
+  success &= contains(json.str(),
+                      R"("test_requests_total": {"type": "counter", "help": "The number of \"requests\".")");
+  success &= contains(json.str(), R"({"labels": {"node": "a\"b\\c"}, "value": 3})");
+  success &= contains(json.str(), R"({"labels": {}, "value": 1.5})");
+  success &= contains(json.str(), R"("buckets": [[1, 1], [2, 2]], "count": 3, "sum": 6)");
+
+  std::ostringstream prometheus{};
+  metrics.writePrometheus(prometheus);
+  std::cout << prometheus.str();
+  success &= contains(prometheus.str(), "# TYPE test_requests_total counter\n");
+  success &= contains(prometheus.str(), "test_requests_total{node=\"a\\\"b\\\\c\"} 3\n");
+  success &= contains(prometheus.str(), "# TYPE test_bytes gauge\ntest_bytes 1.5\n");
+  success &= contains(prometheus.str(), "test_seconds_bucket{node=\"n\",le=\"1\"} 1\n");
+  success &= contains(prometheus.str(), "test_seconds_bucket{node=\"n\",le=\"+Inf\"} 3\n");
+  success &= contains(prometheus.str(), "test_seconds_sum{node=\"n\"} 6\ntest_seconds_count{node=\"n\"} 3\n");
+
+  constexpr std::size_t bytes{std::size_t(1) << 20};
+  void* before{internal::TilePool::allocate(bytes)};
+  Metrics::setEnabled(true);
+  internal::TilePool::deallocate(before, bytes);
+  void* after{internal::TilePool::allocate(bytes)};
+  const auto peak{Metrics::global().gauge("imagegraph_tile_bytes_peak", "").value()};
+  internal::TilePool::deallocate(after, bytes);
+  Metrics::setEnabled(false);
+  std::cout << "tile bytes peak: " << peak << std::endl;
+  if (peak < bytes) {
+    std::cerr << "The peak of the tile bytes does not include the tile in use!" << std::endl;
+    success = false;
+  }
+
+  {
+    NodeGraph graph{};
+    auto& source{graph.createOutNode<ConstantNode>(Node::dimensions_t{64, 64})};
+    graph.createSinkNode<DiscardingSinkNode>(graph.createOutNode<GammaNode<float32_t, float32_t>>(source, false, 2.f));
+    graph.createSinkNode<DiscardingSinkNode>(graph.createOutNode<GammaNode<float32_t, float32_t>>(source, false, 2.f));
+    Metrics::setEnabled(true);
+    graph.compute(std::size_t(1) << 20, 1, NodeGraph::Planner::GREEDY);
+    Metrics::setEnabled(false);
+  }
+  std::ostringstream labels{};
+  Metrics::global().writePrometheus(labels);
+  const std::string gamma{"{node=\"[GammaNode<float, float>(input=?, gamma=2, dither=NONE) @ ?] #"};
+  success &= contains(labels.str(), "imagegraph_cache_requests_total" + gamma + "0\"}");
+  success &= contains(labels.str(), "imagegraph_cache_requests_total" + gamma + "1\"}");
+  if (labels.str().find("0x") != std::string::npos) {
+    std::cerr << "A node label contains an address!" << std::endl;
+    success = false;
+  }
+
+  return success ? 0 : 1;
+}
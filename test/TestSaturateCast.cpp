@@ -0,0 +1,32 @@
+#include "internal/typing/NumberConversion.hpp"
+#include <iostream>
+#include <limits>
+
+using namespace ImageGraph;
+using namespace ImageGraph::internal;
+
+template<typename OutputType, typename InputType> bool check(InputType input, OutputType expected) {
+  const OutputType output{saturate_cast<OutputType>(input)};
+  std::cout << type_name<InputType>() << " " << input << " → " << type_name<OutputType>() << " " << +output
+            << std::endl;
+  if (output == expected) return true;
+  std::cerr << "Expected " << expected << "!" << std::endl;
+  return false;
+}
+
+/**
+ * Negative floating point values have to be preserved, as the smallest value of a floating point type is lowest(),
+ * while min() is its smallest positive normal value.
+ */
+int main() {
+  bool success{true};
+  success &= check<float32_t>(-.25, -.25f);
+  success &= check<float64_t>(-.25f, -.25);
+  success &= check<float16_t>(-.25f, float16_t(-.25f));
+  success &= check<float32_t>(-1e300, std::numeric_limits<float32_t>::lowest());
+  success &= check<float32_t>(1e300, std::numeric_limits<float32_t>::max());
+  success &= check<std::uint8_t>(-3.f, std::uint8_t(0));
+  success &= check<std::int16_t>(-1e6f, std::numeric_limits<std::int16_t>::lowest());
+  success &= check<float64_t>(convert_normalized<false, float32_t>(-.05f), float64_t(-.05f));
+  return success ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "core/nodes/impl/SimpleSink.hpp"
+#include "core/nodes/impl/Vips.hpp"
+#include "core/optimizers/ShrinkOnLoadOptimizer.hpp"
+#include <filesystem>
+#include <iostream>
+#include <vector>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using resize_t = BlockResizeNode<std::uint8_t, float32_t>;
+
+template<typename InputType> struct DiscardingSinkNode final : public SimpleSinkNode<InputType> {
+protected:
+  void handleTile(std::shared_ptr<Tile<InputType>>) const final {}
+
+public:
+  DiscardingSinkNode(OutputNode<InputType>& input) : SimpleSinkNode<InputType>{input} {}
+  SinkNode::relevance_t relevance() const final { return 1; }
+};
+
+/**
+ * Writes a JPEG of the given size, which can be shrunk by 2, 4 or 8 while decoding.
+ */
+std::string writeJpeg(std::size_t size) {
+  const std::string path{(std::filesystem::temp_directory_path() / "TestShrinkOnLoad.jpg").string()};
+  std::vector<std::uint8_t> pixels(size * size, 128);
+  VipsImage* image{vips_image_new_from_memory(pixels.data(), pixels.size(), int(size), int(size), 1,
+                                              VIPS_FORMAT_UCHAR)};
+  if (not image or vips_image_write_to_file(image, path.c_str(), nullptr)) vips_error_exit(nullptr);
+  g_object_unref(image);
+  return path;
+}
+
+/**
+ * @return Whether the optimizer has left the graph consisting of the given loader and resize alone.
+ */
+bool isUnchanged(const NodeGraph& graph, const LoadNode<std::uint8_t>& loader, const resize_t& resize) {
+  return graph.outNodes().size() == 2 and not loader.hasParents() and not resize.hasParents();
+}
+
+/**
+ * A loader only feeding a downscaling resize is replaced by a loader decoding at a reduced size and a residual resize
+ * with the same dimensions, while loaders with other successors and resizes by factors above 1/2 are left alone.
+ */
+int main() {
+  if (VIPS_INIT("ImageGraph")) vips_error_exit(nullptr);
+  constexpr std::size_t size{256};
+  const std::string path{writeJpeg(size)};
+
+  {
+    NodeGraph graph{};
+    graph.createOptimizer<optimizers::ShrinkOnLoadOptimizer>();
+    auto& loader{graph.createOutNode<LoadNode<std::uint8_t>>(path)};
+    auto& resize{graph.createOutNode<resize_t>(loader, .2f, .2f, false)};
+    graph.createSinkNode<DiscardingSinkNode<float32_t>>(resize);
+    graph.optimize();
+
+    const LoadNode<std::uint8_t>* shrunk{nullptr};
+    for (const auto& node : graph.outNodes())
+      if (auto load{dynamic_cast<const LoadNode<std::uint8_t>*>(node.get())}; load and load != &loader) shrunk = load;
+    if (not shrunk or shrunk->shrink() != 4 or shrunk->width() != size / 4 or not loader.hasParents()) {
+      std::cerr << "The loader is not shrunk by 4!" << std::endl;
+      return 1;
+    }
+    const OutNode& residual{resize.outputNode()};
+    if (&residual == &resize or residual.dimensions() != resize.dimensions() or
+        &dynamic_cast<const resize_t&>(residual).typedInputNode() != shrunk) {
+      std::cerr << "The residual resize does not read the shrunk loader or has other dimensions!" << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    NodeGraph graph{};
+    graph.createOptimizer<optimizers::ShrinkOnLoadOptimizer>();
+    auto& loader{graph.createOutNode<LoadNode<std::uint8_t>>(path)};
+    auto& resize{graph.createOutNode<resize_t>(loader, .2f, .2f, false)};
+    graph.createSinkNode<DiscardingSinkNode<float32_t>>(resize);
+    graph.createSinkNode<DiscardingSinkNode<std::uint8_t>>(loader);
+    graph.optimize();
+    if (not isUnchanged(graph, loader, resize)) {
+      std::cerr << "A loader with another successor is shrunk!" << std::endl;
+      return 1;
+    }
+  }
+
+  {
+    NodeGraph graph{};
+    graph.createOptimizer<optimizers::ShrinkOnLoadOptimizer>();
+    auto& loader{graph.createOutNode<LoadNode<std::uint8_t>>(path)};
+    auto& resize{graph.createOutNode<resize_t>(loader, .6f, .6f, false)};
+    graph.createSinkNode<DiscardingSinkNode<float32_t>>(resize);
+    graph.optimize();
+    if (not isUnchanged(graph, loader, resize)) {
+      std::cerr << "A loader is shrunk for a resize by a factor above 1/2!" << std::endl;
+      return 1;
+    }
+  }
+
+  std::filesystem::remove(path);
+}
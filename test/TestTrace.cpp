@@ -0,0 +1,94 @@
+#include "JsonValidator.hpp"
+#include "core/NodeGraph.hpp"
+#include "core/Trace.hpp"
+#include "core/nodes/TiledInputOutputNode.hpp"
+#include "core/nodes/impl/PerPixel.hpp"
+#include "core/nodes/impl/SimpleSink.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace ImageGraph;
+using namespace ImageGraph::nodes;
+
+using rectangle_t = Node::rectangle_t;
+
+/**
+ * A constant source, which is kept in full memory like a loaded image.
+ */
+struct ConstantNode final : public TiledInputOutputNode<float32_t> {
+protected:
+  OutNode::duration_t tileDuration(rectangle_t) const final { return {}; }
+  void updateTileDuration(OutNode::duration_t, rectangle_t) const final {}
+
+  void setCacheBytes(std::size_t) const final {}
+  std::unique_ptr<OutNode::proto_cache_t> createProtoCache() const final { return nullptr; }
+
+  rectangle_t rawInputRegion(Node::input_index_t, rectangle_t) const final {
+    throw std::invalid_argument("There are no inputs!");
+  }
+
+  std::ostream& print(std::ostream& stream) const final { return stream << "[ConstantNode @ " << this << "]"; }
+
+public:
+  void compute(std::tuple<>, Tile<float32_t>& output) const final { std::fill(output.begin(), output.end(), .5f); }
+
+  ConstantNode(Node::dimensions_t dimensions)
+      : OutNode(dimensions, 1, 0, internal::MemoryMode::FULL_MEMORY, typeid(float32_t)) {}
+};
+
+struct DiscardingSinkNode final : public SimpleSinkNode<float32_t> {
+protected:
+  void handleTile(std::shared_ptr<Tile<float32_t>>) const final {}
+
+public:
+  using SimpleSinkNode::SimpleSinkNode;
+  relevance_t relevance() const final { return 1; }
+};
+
+bool contains(const std::string& line, const std::string& part) { return line.find(part) != std::string::npos; }
+
+/**
+ * Traces a computation and checks that the Chrome trace parses, that every complete event has a start and a duration,
+ * and that the events of finished dependencies name the dependency instead of the task itself.
+ */
+int main() {
+  constexpr std::size_t size{1024};
+  NodeGraph graph{};
+  auto& source{graph.createOutNode<ConstantNode>(Node::dimensions_t{size, size})};
+  auto& gamma{graph.createOutNode<GammaNode<float32_t, float32_t>>(source, false, 2.2f)};
+  graph.createSinkNode<DiscardingSinkNode>(gamma);
+
+  Trace::setEnabled(true);
+  graph.compute(size * size * sizeof(float32_t), 1, NodeGraph::Planner::GREEDY);
+  Trace::setEnabled(false);
+
+  std::ostringstream trace{};
+  Trace::writeChromeJson(trace);
+  bool success{JsonValidator{trace.str()}.valid()};
+  if (not success) std::cerr << "The trace does not parse!" << std::endl;
+
+  std::istringstream lines{trace.str()};
+  std::size_t complete{0}, dependencies{0};
+  for (std::string line{}; std::getline(lines, line);) {
+    if (not contains(line, R"("ph": "X")")) continue;
+    ++complete;
+    if (not contains(line, R"("ts": )") or not contains(line, R"("dur": )")) {
+      std::cerr << "The event has no start or duration: " << line << std::endl;
+      success = false;
+    }
+    if (contains(line, R"("name": "performSingle")")) {
+      if (not contains(line, R"("dependency": ")") or not contains(line, R"("dependency_region": ")")) {
+        std::cerr << "The event does not name its dependency: " << line << std::endl;
+        success = false;
+      }
+      ++dependencies;
+    }
+  }
+  std::cout << complete << " complete events, " << dependencies << " of which handle a dependency" << std::endl;
+  if (not complete or not dependencies) {
+    std::cerr << "The trace does not contain the expected events!" << std::endl;
+    success = false;
+  }
+  return success ? 0 : 1;
+}